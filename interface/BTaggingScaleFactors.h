@@ -11,7 +11,8 @@
 
 #include <array>
 #include <memory>
-#include <tuple>
+#include <string>
+#include <vector>
 
 enum class Algorithm {
     UNKNOWN = -1,
@@ -33,11 +34,22 @@ enum class SystFlavor {
     LIGHT = 2
 };
 
+/**
+ * A b-tagging discriminator stored by a jets producer, with its algorithm resolved
+ * once at construction time
+ */
+struct BTagDiscriminator {
+    std::string name;
+    std::vector<float>* branch;
+    Algorithm algo; // UNKNOWN if no scale-factors are available for this discriminator
+};
+
 class BTaggingScaleFactors {
 
     public:
-        typedef std::tuple<Algorithm, SystFlavor, std::string> branch_key_type;
-        typedef std::tuple<Algorithm, Flavor, std::string> sf_key_type;
+        // Number of supported algorithms and flavors, used to size the dense tables below
+        static const std::size_t N_ALGORITHMS = 5;
+        static const std::size_t N_FLAVORS = 3;
 
         static std::array<SystFlavor, 2> SystFlavors;
 
@@ -48,22 +60,95 @@ class BTaggingScaleFactors {
 
         virtual void create_branches(const edm::ParameterSet&) final;
 
+        /**
+         * Compute and store the scale-factors of one jet. In deferred mode, see ScaleFactors,
+         * only the parameters are recorded until evaluate_scale_factors is called.
+         */
         virtual void store_scale_factors(Algorithm algo, Flavor flavor, const Parameters&, bool isData) final;
 
+        /**
+         * Store the per-event b-tagging weights, once all the jets of the event have been passed
+         * to store_scale_factors. Only working points with efficiency maps have event weights.
+         */
+        virtual void store_event_weights() final;
+
+        virtual void evaluate_scale_factors() final;
+        virtual void clear_scale_factors() final;
+
         virtual bool has_scale_factors(Algorithm algo) final {
-            return m_algos.count(algo) != 0;
+            return algo != Algorithm::UNKNOWN && !m_working_points[static_cast<size_t>(algo)].empty();
         }
 
     protected:
         virtual float get_scale_factor(Algorithm algo, Flavor flavor, const std::string& wp, size_t index, Variation variation = Variation::Nominal) final;
 
     private:
+        struct ScaleFactor {
+            std::shared_ptr<const BinnedValues> values;
+            std::size_t layout = BinnedValuesLookupContext::NO_LAYOUT;
+        };
+
+        /**
+         * Per-event weight of one working point, computed from the scale-factors and the
+         * b-tagging efficiencies of all the jets of the event (method 1a):
+         *
+         *   w = prod_{tagged} SF_i * prod_{not tagged} (1 - SF_i * eff_i) / (1 - eff_i)
+         *
+         * One weight is stored for each syst flavor, with only the scale-factors of the
+         * jets of this syst flavor varied up or down.
+         */
+        struct EventWeight {
+            bool enabled = false;
+            float discriminator_cut;
+            std::array<ScaleFactor, N_FLAVORS> efficiencies;
+
+            // Indexed by SystFlavor - 1, then Variation
+            std::array<std::array<double, 3>, 2> weights;
+            std::array<std::vector<float>*, 2> branches;
+
+            void reset() {
+                for (auto& w: weights)
+                    w.fill(1.);
+            }
+        };
+
+        /**
+         * Everything needed to store the scale-factors of one working point, indexed
+         * by flavor and syst flavor. No string is involved once the branches are created.
+         */
+        struct WorkingPoint {
+            std::string name;
+            std::array<ScaleFactor, N_FLAVORS> scale_factors;
+            std::array<std::vector<std::vector<float>>*, 2> branches; // Indexed by SystFlavor - 1
+
+            // Entry stored for data and for jets of another flavor, with the same layout as the
+            // scale-factors of the branch. Indexed by SystFlavor - 1
+            std::array<std::vector<float>, 2> unit_values;
+            EventWeight event_weight;
+        };
+
+        struct PendingScaleFactor {
+            Algorithm algo;
+            Flavor flavor;
+            Parameters parameters;
+            bool isData;
+        };
+
+        void compute_scale_factors(Algorithm algo, Flavor flavor, const Parameters&, bool isData);
+
         ROOT::TreeGroup& m_tree;
 
-        std::map<branch_key_type, std::vector<std::vector<float>>*> m_branches;
-        std::map<sf_key_type, std::unique_ptr<BinnedValues>> m_scale_factors;
+        bool m_deferred = false;
+        std::vector<PendingScaleFactor> m_pending;
+        bool m_event_weights_pending = false;
+
+        void compute_event_weights();
+
+        // Working points, indexed by algorithm
+        std::array<std::vector<WorkingPoint>, N_ALGORITHMS> m_working_points;
 
-        std::map<Algorithm, std::vector<std::string>> m_algos;
+        // Most working points share the same binning: search for the bin only once per jet
+        BinnedValuesLookupContext m_lookup;
 
     public:
         static inline std::string algorithm_to_string(Algorithm algo) {
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cp3_llbb/Framework/interface/CounterBasedRandom.h>
 #include <cp3_llbb/Framework/interface/Histogram.h>
+#include <cp3_llbb/Framework/interface/MultilinearInterpolation.h>
 
+#include <limits>
+#include <array>
 #include <memory>
 #include <unordered_map>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <TFormula.h>
 
@@ -14,6 +20,15 @@ enum Variation {
     Up = 2
 };
 
+/**
+ * Index of the @p variation (Down or Up) of the uncertainty component @p component in the values
+ * returned by BinnedValues::get(). Components follow the nominal value and the total errors, with
+ * the down error of each component stored before the up one.
+ */
+inline std::size_t componentIndex(std::size_t component, Variation variation) {
+    return 3 + 2 * component + (variation == Up ? 1 : 0);
+}
+
 template <typename T, typename U>
 struct bimap {
     typedef std::unordered_map<T, U> left_type;
@@ -66,23 +81,66 @@ namespace std {
 
 class Parameters {
     public:
-        typedef std::unordered_map<BinningVariable, float> value_type;
+        typedef std::pair<BinningVariable, float> value_type;
+
+        // Number of values of the BinningVariable enum
+        static const std::size_t N_VARIABLES = 4;
 
         Parameters() = default;
-        Parameters(Parameters&& rhs);
-        Parameters(std::initializer_list<typename value_type::value_type> init);
+        Parameters(const Parameters& rhs) = default;
+        Parameters(Parameters&& rhs) = default;
+        Parameters& operator=(const Parameters& rhs) = default;
+        Parameters& operator=(Parameters&& rhs) = default;
+        Parameters(std::initializer_list<value_type> init);
 
 
         Parameters& setPt(float pt);
         Parameters& setEta(float eta);
         Parameters& setBTagDiscri(float d);
         Parameters& set(const BinningVariable& bin, float value);
-        Parameters& set(const typename value_type::value_type& value);
+        Parameters& set(const value_type& value);
+
+        float get(const BinningVariable& bin) const;
+
+        /**
+         * Identify the object these parameters are evaluated for. Used by values
+         * needing random numbers, see WeightedBinnedValues
+         */
+        Parameters& setRandomKey(const RandomKey& key);
+
+        bool hasRandomKey() const {
+            return m_has_random_key;
+        }
+
+        const RandomKey& getRandomKey() const {
+            return m_random_key;
+        }
 
         std::vector<float> toArray(const std::vector<BinningVariable>&) const;
 
+        /**
+         * Same as above, reusing the memory of @p values
+         */
+        void toArray(const std::vector<BinningVariable>&, std::vector<float>& values) const;
+
     private:
-        value_type m_values;
+        // Values are stored in a flat array indexed by BinningVariable
+        std::array<float, N_VARIABLES> m_values;
+        std::array<bool, N_VARIABLES> m_is_set = {{false, false, false, false}};
+
+        RandomKey m_random_key;
+        bool m_has_random_key = false;
+};
+
+/**
+ * Result of a bin search for a given set of parameters
+ */
+struct ResolvedBin {
+    std::size_t bin = 0;
+    bool outOfRange = false;
+
+    // Values of the binning variables, in the order of the binning
+    std::vector<float> variables;
 };
 
 class BinnedValues {
@@ -104,31 +162,57 @@ class BinnedValues {
     };
 
     friend class BinnedValuesJSONParser;
+    friend class BinnedValuesBinaryParser;
+    friend class CombinedBinnedValues;
 
     BinnedValues(BinnedValues&& rhs) = default;
 
     BinnedValues() = default;
 
+    /**
+     * Names of the uncertainty components, in addition to the total errors. See componentIndex()
+     */
+    const std::vector<std::string>& getComponents() const {
+        return components;
+    }
+
+    /**
+     * Values to use when no scale-factor applies (for example on data): 1, without any error
+     */
+    std::vector<float> getUnitValues() const {
+        std::vector<float> values(3 + 2 * components.size(), 0.);
+        values[Nominal] = 1.;
+
+        return values;
+    }
+
+    protected:
+    std::vector<std::string> components;
+
     private:
+    // The binning is validated when the values are loaded: any set of variables maps to a bin
     template <typename _Value>
-        std::vector<_Value> get(Histogram<_Value, float>& h, const std::vector<float>& bins, bool& outOfRange) const {
-            std::size_t bin = h.findClosestBin(bins, &outOfRange);
-            if (bin == 0) {
-                std::stringstream msg;
-                msg << "Failed to found the right bin for a scale-factor. This should not happend. Bins: [";
-                for (float b: bins) {
-                    msg << b << ", ";
-                }
-
-                msg.seekp(msg.tellp() - 2l);
-                msg << "]";
-
-                throw std::runtime_error(msg.str());
-            }
+        void resolve_bin(Histogram<_Value, float>& h, ResolvedBin& result) const {
+            result.bin = h.findClosestBin(result.variables, &result.outOfRange);
+        }
+
+    std::vector<float> get_binned_content(std::size_t bin) const {
+        const auto& h = *binned;
+
+        std::vector<float> values;
+        values.reserve(3 + 2 * components.size());
+        values.push_back(h.getBinContent(bin));
+        values.push_back(h.getBinErrorLow(bin));
+        values.push_back(h.getBinErrorHigh(bin));
 
-            return {h.getBinContent(bin), h.getBinErrorLow(bin), h.getBinErrorHigh(bin)};
+        if (! components.empty()) {
+            const float* errors = component_errors + (bin - 1) * 2 * components.size();
+            values.insert(values.end(), errors, errors + 2 * components.size());
         }
 
+        return values;
+    }
+
     void setVariables(const std::vector<std::string>&);
 
     // List of variables used in the binning. First entry is the X variable, second one Y, etc.
@@ -142,6 +226,14 @@ class BinnedValues {
     // Formula data
     std::shared_ptr<Histogram<std::shared_ptr<TFormula>, float>> formula;
 
+    // Only set if values are interpolated between bin centres ("interpolation": "linear" in the JSON file)
+    std::shared_ptr<MultilinearInterpolation> interpolation;
+
+    // Down and up errors of each uncertainty component, stored contiguously for each bin
+    // (binned data only). component_storage owns the memory
+    const float* component_errors = nullptr;
+    std::shared_ptr<const void> component_storage;
+
     ErrorType error_type;
     size_t formula_variable_index = -1; // Only used in formula mode
 
@@ -149,76 +241,102 @@ class BinnedValues {
     float minimum;
 
     /**
-     * Convert relative errors to absolute errors
+     * Convert relative errors to absolute errors, in place
      **/
-    std::vector<float> relative_errors_to_absolute(const std::vector<float>& array) const {
-        std::vector<float> result(3);
-        result[Nominal] = array[Nominal];
-        result[Up] = array[Nominal] * array[Up];
-        result[Down] = array[Nominal] * array[Down];
-
-        return result;
+    void relative_errors_to_absolute(std::vector<float>& array) const {
+        for (std::size_t i = 1; i < array.size(); i++)
+            array[i] *= array[Nominal];
     };
 
     /**
-     * Convert variated errors to absolute errors
+     * Convert variated errors to absolute errors, in place
      **/
-    std::vector<float> variated_errors_to_absolute(const std::vector<float>& array) const {
-        std::vector<float> result(3);
-        result[Nominal] = array[Nominal];
-        result[Up] = std::abs(array[Up] - array[Nominal]);
-        result[Down] = std::abs(array[Nominal] - array[Down]);
-
-        return result;
+    void variated_errors_to_absolute(std::vector<float>& array) const {
+        for (std::size_t i = 1; i < array.size(); i++)
+            array[i] = std::abs(array[i] - array[Nominal]);
     };
 
-    std::vector<float> convert_errors(const std::vector<float>& array) const {
+    void convert_errors(std::vector<float>& array) const {
         switch (error_type) {
             case ErrorType::ABSOLUTE:
-                return array;
+                break;
 
             case ErrorType::RELATIVE:
-                return relative_errors_to_absolute(array);
+                relative_errors_to_absolute(array);
+                break;
 
             case ErrorType::VARIATED:
-                return variated_errors_to_absolute(array);
+                variated_errors_to_absolute(array);
+                break;
         }
-
-        throw std::runtime_error("Invalid error type");
     }
 
     /**
-     * Check that the up and down variation are
-     * still between the allowed range
+     * Check that the up and down variations (total and components)
+     * are still between the allowed range
      **/
     void clamp(std::vector<float>& array) const {
-        if ((array[Nominal] + array[Up]) > maximum) {
-            array[Up] = maximum - array[Nominal];
-        }
+        for (std::size_t i = Down; i < array.size(); i += 2) {
+            if ((array[Nominal] - array[i]) < minimum) {
+                array[i] = -(minimum - array[Nominal]);
+            }
 
-        if ((array[Nominal] - array[Down]) < minimum) {
-            array[Down] = -(minimum - array[Nominal]);
+            if ((array[Nominal] + array[i + 1]) > maximum) {
+                array[i + 1] = maximum - array[Nominal];
+            }
         }
     }
 
     public:
-    virtual std::vector<float> get(const Parameters& parameters) const {
-        static auto double_errors = [](std::vector<float>& values) {
-            values[Up] *= 2;
-            values[Down] *= 2;
-        };
+    /**
+     * Check that @p edges define a valid binning: at least one bin, finite and strictly increasing edges.
+     * Throw an exception mentioning @p file otherwise.
+     */
+    static void validate_binning(const std::vector<float>& edges, const std::string& file);
+
+    /**
+     * Check the whole content once loaded: binning, bins all filled with finite values (or formulas)
+     * and valid range. Throw an exception mentioning @p file otherwise.
+     *
+     * Lookups rely on this validation and do not check anything.
+     */
+    void validate(const std::string& file) const;
 
-        std::vector<float> variables = parameters.toArray(binning_variables);
+    /**
+     * Find the bin corresponding to @p parameters. The result only depends on the binning,
+     * and can be used to evaluate any BinnedValues for which hasSameBinning() is true.
+     */
+    virtual void resolve(const Parameters& parameters, ResolvedBin& result) const {
+        parameters.toArray(binning_variables, result.variables);
+        result.outOfRange = false;
+        result.bin = 0;
+
+        if (!use_formula) {
+            if (binned.get())
+                resolve_bin<float>(*binned.get(), result);
+        } else {
+            if (formula.get())
+                resolve_bin<std::shared_ptr<TFormula>>(*formula.get(), result);
+        }
+    }
 
-        bool outOfRange = false;
+    /**
+     * Evaluate the values for a bin previously found by resolve()
+     */
+    virtual std::vector<float> get(const ResolvedBin& bin) const {
+        static auto double_errors = [](std::vector<float>& values) {
+            for (std::size_t i = Down; i < values.size(); i++)
+                values[i] *= 2;
+        };
 
         if (!use_formula) {
             if (! binned.get())
                 return {0., 0., 0.};
 
-            std::vector<float> values = convert_errors(get<float>(*binned.get(), variables, outOfRange));
+            std::vector<float> values = interpolation ? interpolation->evaluate(bin.variables) : get_binned_content(bin.bin);
+            convert_errors(values);
 
-            if (outOfRange)
+            if (bin.outOfRange)
                 double_errors(values);
 
             clamp(values);
@@ -228,19 +346,20 @@ class BinnedValues {
             if (! formula.get())
                 return {0., 0., 0.};
 
-            std::vector<std::shared_ptr<TFormula>> formulas = get<std::shared_ptr<TFormula>>(*formula.get(), variables, outOfRange);
-            std::vector<float> values;
+            const auto& h = *formula;
 
-            // Ensure variables are not outside the validity range
-            variables = formula->clamp(variables);
+            // Ensure the variable is not outside the validity range
+            float variable = h.clampAxis(formula_variable_index, bin.variables[formula_variable_index]);
 
-            for (auto& formula: formulas) {
-                values.push_back(formula->Eval(variables[formula_variable_index]));
-            }
+            std::vector<float> values = {
+                static_cast<float>(h.getBinContent(bin.bin)->Eval(variable)),
+                static_cast<float>(h.getBinErrorLow(bin.bin)->Eval(variable)),
+                static_cast<float>(h.getBinErrorHigh(bin.bin)->Eval(variable))
+            };
 
-            values = convert_errors(values);
+            convert_errors(values);
 
-            if (outOfRange)
+            if (bin.outOfRange)
                 double_errors(values);
 
             clamp(values);
@@ -249,4 +368,63 @@ class BinnedValues {
         }
     }
 
+    virtual std::vector<float> get(const Parameters& parameters) const {
+        ResolvedBin bin;
+        resolve(parameters, bin);
+
+        return get(bin);
+    }
+
+    /**
+     * Return true if a bin resolved for this object can be used to evaluate @p other, ie
+     * if both depend on the same variables with the same bin edges
+     */
+    bool hasSameBinning(const BinnedValues& other) const;
+
+    /**
+     * Return false if the values can't be evaluated from a resolved bin (for example
+     * if they are built from several sets of values)
+     */
+    virtual bool canShareBins() const {
+        return true;
+    }
+
+    private:
+    std::vector<std::vector<float>> getBinning() const;
+
+};
+
+/**
+ * Evaluate several BinnedValues for the same set of parameters, searching for the bin only
+ * once per distinct binning layout. Values sharing the same binning (like the different
+ * working points of a b-tagging algorithm) then only differ by the content fetch.
+ *
+ * Values are first registered with add_layout(), which returns the layout to use with get().
+ * Then, for each object, call set_parameters() before evaluating any value.
+ */
+class BinnedValuesLookupContext {
+    public:
+        static const std::size_t NO_LAYOUT = std::numeric_limits<std::size_t>::max();
+
+        std::size_t add_layout(const BinnedValues& values);
+
+        /**
+         * Set the parameters used by the next calls to get(). @p parameters must outlive
+         * these calls.
+         */
+        void set_parameters(const Parameters& parameters);
+
+        std::vector<float> get(const BinnedValues& values, std::size_t layout);
+
+        std::size_t size() const {
+            return m_layouts.size();
+        }
+
+    private:
+        // One representative for each layout
+        std::vector<const BinnedValues*> m_layouts;
+
+        std::vector<ResolvedBin> m_bins;
+        std::vector<bool> m_resolved;
+        const Parameters* m_parameters = nullptr;
 };
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cp3_llbb/Framework/interface/Histogram.h>
+#include <cp3_llbb/Framework/interface/BinnedValues.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Loader for the binary representation of BinnedValues, as produced by
+ * scripts/convertScaleFactorsToBinary.py from the JSON files.
+ *
+ * The file is memory-mapped and, for binned values, the histogram content and errors point
+ * directly into the mapping: nothing is parsed or copied, and jobs running on the same node
+ * share the pages. Formulas are stored as strings and still need to be compiled by TFormula.
+ * Interpolation coefficients are not stored, and are computed when the file is loaded.
+ *
+ * Layout (native endianness, every section aligned on 4 bytes):
+ *   - Header (see below)
+ *   - Bin edges: n_edges[0] floats for x, then n_edges[1] for y and n_edges[2] for z
+ *   - Names of the n_components uncertainty components, stored like the formulas below
+ *   - Binned values: n_bins floats for the values, then n_bins for the low errors and n_bins
+ *     for the high errors. Bins are ordered with x running fastest.
+ *   - Uncertainty components (binned values only): for each bin, the low and high errors of
+ *     each component, ie. 2 * n_components * n_bins floats
+ *   - Formulas: for each bin, the value, low error and high error expressions, each one stored
+ *     as a uint32 length followed by the characters, padded to 4 bytes.
+ *
+ * Bins missing from the JSON file are stored as NaN, or as empty expressions, and the file is
+ * rejected when loaded, like the JSON file.
+ */
+class BinnedValuesBinaryParser {
+
+    public:
+        static constexpr const char* EXTENSION = ".sfb";
+        static constexpr uint32_t VERSION = 3;
+
+        struct Header {
+            char magic[8]; // "CP3SFB\0\0"
+            uint32_t version;
+            uint32_t dimension;
+            uint32_t formula; // 1 if the content is made of formulas
+            uint32_t formula_variable_index;
+            uint32_t error_type; // 0: absolute, 1: relative, 2: variated
+            uint32_t interpolation; // 0: none, 1: linear
+            float minimum;
+            float maximum;
+            char variables[3][16]; // Name of the binning variables, as in the JSON files
+            uint32_t n_edges[3];
+            uint32_t n_bins;
+            uint32_t n_components;
+        };
+
+        static_assert(sizeof(Header) == 108, "Unexpected padding in the binary scale-factors header");
+
+        BinnedValuesBinaryParser(const std::string& file) {
+            parse_file(file);
+        }
+
+        virtual BinnedValues&& get_values() final {
+            return std::move(m_values);
+        }
+
+        static bool is_binary_file(const std::string& file);
+
+    private:
+        void parse_file(const std::string& file);
+
+        BinnedValues m_values;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * C interface to BinnedValues, used by the python binding (python/BinnedValues.py) through ctypes.
+ *
+ * Values are evaluated exactly like in the framework: same parser, same lookup and parameters stored
+ * as float. For each object, 'nominal', 'up' and 'down' receive the content of the sf_* branches,
+ * ie. the nominal value and the absolute up and down errors.
+ *
+ * Functions returning an int return 0 on success. On failure, a description of the error is copied
+ * into @p error, truncated to @p error_size characters.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BinnedValuesHandle BinnedValuesHandle;
+
+/**
+ * Load a JSON or binary scale-factors file. Return NULL on failure.
+ */
+BinnedValuesHandle* binned_values_load(const char* file, char* error, size_t error_size);
+
+void binned_values_free(BinnedValuesHandle* values);
+
+/**
+ * Evaluate @p n objects. @p pt, @p eta and @p discri may be NULL if the values do not depend on them.
+ */
+int binned_values_evaluate(const BinnedValuesHandle* values, size_t n, const float* pt, const float* eta, const float* discri,
+        float* nominal, float* up, float* down, char* error, size_t error_size);
+
+/**
+ * Number of uncertainty components, in addition to the total errors, and name of component @p index
+ */
+size_t binned_values_n_components(const BinnedValuesHandle* values);
+const char* binned_values_component_name(const BinnedValuesHandle* values, size_t index);
+
+/**
+ * Evaluate the uncertainty components of @p n objects. For each object, @p components receives the
+ * absolute down and up errors of each component, ie. 2 * binned_values_n_components() floats.
+ */
+int binned_values_evaluate_components(const BinnedValuesHandle* values, size_t n, const float* pt, const float* eta, const float* discri,
+        float* components, char* error, size_t error_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,7 @@
 #include <boost/property_tree/ptree.hpp>
 
 #include <memory>
+#include <stdexcept>
 
 #include <TFormula.h>
 
@@ -44,6 +45,8 @@ class BinnedValuesJSONParser {
         template <class T, typename _Value>
         void fillHistogram(T& h, const std::vector<float>& bins, const _Value& value, const _Value& error_low, const _Value& error_high) {
             std::size_t bin = h.findBin(bins);
+            if (bin == 0)
+                throw std::runtime_error("A bin of the data section is outside the binning");
 
             h.setBinContent(bin, value);
             h.setBinErrorLow(bin, error_low);
@@ -61,6 +64,27 @@ class BinnedValuesJSONParser {
             fillHistogram(*val.formula.get(), bins, value_formula, error_low_formula, error_high_formula);
         }
 
+        template <typename _Content>
+        void parse_bin(boost::property_tree::ptree& ptree, const std::vector<float>& bins) {
+            _Content value = ptree.get<_Content>("value");
+            _Content error_low = ptree.get<_Content>("error_low");
+            _Content error_high = ptree.get<_Content>("error_high");
+
+            fillHistogram(m_values, bins, value, error_low, error_high);
+
+            if (m_values.components.empty())
+                return;
+
+            // Uncertainty components are only supported for binned values
+            std::size_t bin = m_values.binned->findBin(bins);
+            float* errors = m_component_errors + (bin - 1) * 2 * m_values.components.size();
+            for (const auto& component: m_values.components) {
+                boost::property_tree::ptree& errors_ptree = ptree.get_child("components." + component);
+                *errors++ = errors_ptree.get<float>("error_low");
+                *errors++ = errors_ptree.get<float>("error_high");
+            }
+        }
+
         template <typename _Content>
         void parse_data(boost::property_tree::ptree& ptree, std::size_t dimension) {
             for (auto& data_x: ptree.get_child("data")) {
@@ -78,34 +102,26 @@ class BinnedValuesJSONParser {
                             for (auto& data_z: data_y.second.get_child("values")) {
                                 std::vector<float> binning_z = get_array(data_z.second.get_child("bin"));
                                 float mean_z = (binning_z[0] + binning_z[1]) / 2.;
-                                _Content value = data_z.second.get<_Content>("value");
-                                _Content error_low = data_z.second.get<_Content>("error_low");
-                                _Content error_high = data_z.second.get<_Content>("error_high");
 
-                                fillHistogram(m_values, {mean_x, mean_y, mean_z}, value, error_low, error_high);
+                                parse_bin<_Content>(data_z.second, {mean_x, mean_y, mean_z});
                             }
 
                         } else {
 
-                            _Content value = data_y.second.get<_Content>("value");
-                            _Content error_low = data_y.second.get<_Content>("error_low");
-                            _Content error_high = data_y.second.get<_Content>("error_high");
-
-                            fillHistogram(m_values, {mean_x, mean_y}, value, error_low, error_high);
+                            parse_bin<_Content>(data_y.second, {mean_x, mean_y});
                         }
 
                     }
 
                 } else {
 
-                    _Content value = data_x.second.get<_Content>("value");
-                    _Content error_low = data_x.second.get<_Content>("error_low");
-                    _Content error_high = data_x.second.get<_Content>("error_high");
-
-                    fillHistogram(m_values, {mean_x}, value, error_low, error_high);
+                    parse_bin<_Content>(data_x.second, {mean_x});
                 }
             }
         }
 
         BinnedValues m_values;
+
+        // Storage of the uncertainty components of m_values, being filled
+        float* m_component_errors = nullptr;
 };
@@ -3,6 +3,7 @@
 
 #include <CommonTools/Utils/interface/StringCutObjectSelector.h>
 
+#include <cp3_llbb/Framework/interface/CounterBasedRandom.h>
 #include <cp3_llbb/Framework/interface/Producer.h>
 
 template<typename ObjectType>
@@ -41,6 +42,27 @@ class CandidatesProducer: public Framework::Producer {
             return m_cut(p);
         }
 
+        /**
+         * Identify the candidate at position @p index of the input collection, for random numbers
+         * drawn while evaluating its scale-factors.
+         *
+         * The index in the input collection does not depend on the cut, so a clone of the producer
+         * running on a shifted collection draws the same numbers for the same object, as long as
+         * the shifted collection keeps the order of the nominal one. This is not the case for the
+         * JEC-shifted jets, which ShiftedJetProducerWithSourcesT sorts again by pt: jets whose
+         * position changes may get a different part of weighted scale-factors in the up and down
+         * clones. Use combined scale-factors (see CombinedBinnedValues) where this matters.
+         */
+        RandomKey random_key(const edm::Event& event, size_t index) const {
+            RandomKey key;
+            key.run = event.id().run();
+            key.lumi = event.id().luminosityBlock();
+            key.event = event.id().event();
+            key.object = index;
+
+            return key;
+        }
+
     private:
         // Cut
         StringCutObjectSelector<ObjectType> m_cut;
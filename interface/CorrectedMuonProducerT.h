@@ -22,11 +22,11 @@
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 
+#include <cp3_llbb/Framework/interface/CounterBasedRandom.h>
 #include <cp3_llbb/Framework/interface/Rochester.h>
 #include <KaMuCa/Calibration/interface/KalmanMuonCalibrator.h>
 
 #include <memory>
-#include <random>
 #include <boost/filesystem.hpp>
 
 namespace cp3 {
@@ -39,7 +39,7 @@ namespace cp3 {
             }
 
             template<typename T>
-            T correct(const edm::Event& event, const T& muon) {
+            T correct(const edm::Event& event, const T& muon, size_t /* index */) {
                 auto corrected_pt = corrector->getCorrectedPt(muon.pt(), muon.eta(), muon.phi(), muon.charge());
                 if (! event.isRealData())
                     corrected_pt = corrector->smear(corrected_pt, muon.eta());
@@ -58,8 +58,7 @@ namespace cp3 {
 
     class RochesterCorrector {
         public:
-            explicit RochesterCorrector(const edm::ParameterSet& cfg):
-                random_generator(42), random_distribution(0, 1) {
+            explicit RochesterCorrector(const edm::ParameterSet& cfg) {
                 auto tag = cfg.getParameter<edm::FileInPath>("input");
 
                 // Constructor expect a path to the directory, but edm::FileInPath does not support folders
@@ -69,8 +68,13 @@ namespace cp3 {
                 corrector.reset(new RoccoR(p.parent_path().native()));
             }
 
+            /**
+             * Random numbers used for the MC smearing only depend on the event and on
+             * the index of the muon in the input collection, so the corrections are
+             * reproducible whatever the processing order.
+             */
             template<typename T>
-            T correct(const edm::Event& event, const T& muon) {
+            T correct(const edm::Event& event, const T& muon, size_t index) {
 
                 float scale_factor = 1.;
 
@@ -81,11 +85,20 @@ namespace cp3 {
                     if (!muon.innerTrack().isNull())
                         n_tracks = muon.innerTrack()->hitPattern().trackerLayersWithMeasurement();
 
+                    RandomKey key;
+                    key.run = event.id().run();
+                    key.lumi = event.id().luminosityBlock();
+                    key.event = event.id().event();
+                    key.object = index;
+                    key.purpose = random_purpose;
+
+                    auto random = CounterBasedRandom::uniform(key);
+
                     auto gen_particle = muon.genParticle();
                     if (gen_particle)
-                        scale_factor = corrector->kScaleFromGenMC(muon.charge(), muon.pt(), muon.eta(), muon.phi(), n_tracks, gen_particle->pt(), random_distribution(random_generator), 0 /* set */, 0 /* param */);
+                        scale_factor = corrector->kScaleFromGenMC(muon.charge(), muon.pt(), muon.eta(), muon.phi(), n_tracks, gen_particle->pt(), random[0], 0 /* set */, 0 /* param */);
                     else
-                        scale_factor = corrector->kScaleAndSmearMC(muon.charge(), muon.pt(), muon.eta(), muon.phi(), n_tracks, random_distribution(random_generator), random_distribution(random_generator), 0 /* set */, 0 /* param */);
+                        scale_factor = corrector->kScaleAndSmearMC(muon.charge(), muon.pt(), muon.eta(), muon.phi(), n_tracks, random[0], random[1], 0 /* set */, 0 /* param */);
                 }
 
                 if (std::isnan(scale_factor)) {
@@ -100,8 +113,7 @@ namespace cp3 {
 
         private:
             std::unique_ptr<RoccoR> corrector;
-            std::mt19937 random_generator;
-            std::uniform_real_distribution<double> random_distribution;
+            const uint32_t random_purpose = CounterBasedRandom::purpose("RochesterCorrector");
     };
 }
 
@@ -134,7 +146,8 @@ class CorrectedMuonProducerT : public edm::stream::EDProducer<> {
         std::unique_ptr<MuonCollection> corrected_muons(new MuonCollection());
         std::vector<float> correction_factors;
 
-        for (const auto& muon: muons) {
+        for (size_t index = 0; index < muons.size(); index++) {
+            const auto& muon = muons[index];
             if ((! enabled) || muon.pt() == 0) {
                 corrected_muons->push_back(muon);
                 correction_factors.push_back(1);
@@ -142,7 +155,7 @@ class CorrectedMuonProducerT : public edm::stream::EDProducer<> {
             }
 
             // Correct muon
-            T corrected_muon = corrector->template correct<T>(event, muon);
+            T corrected_muon = corrector->template correct<T>(event, muon, index);
 
             double ratio = corrected_muon.pt() / muon.pt();
 
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+/**
+ * Identify the object a random number is drawn for. The same key always
+ * gives the same random numbers, whatever the order in which events and
+ * objects are processed.
+ */
+struct RandomKey {
+    uint32_t run = 0;
+    uint32_t lumi = 0;
+    uint64_t event = 0;
+    uint32_t object = 0; // Index of the object inside the event
+    uint32_t purpose = 0; // Distinguish independent draws for the same object. See CounterBasedRandom::purpose
+};
+
+/**
+ * Stateless counter-based random generator (Philox4x32-10, see Salmon et al.,
+ * "Parallel random numbers: as easy as 1, 2, 3", SC11).
+ *
+ * Random numbers are a pure function of the key: there is no state to share
+ * between threads, and results do not depend on the processing order, on how
+ * the events are split between jobs or on skipped events.
+ *
+ * The 128 bits counter is made of the event number, the luminosity block and
+ * the object index, the 64 bits key of the run number and the purpose.
+ */
+class CounterBasedRandom {
+    public:
+        typedef std::array<uint32_t, 4> result_type;
+
+        static result_type generate(const RandomKey& key) {
+            result_type counter = {{static_cast<uint32_t>(key.event), static_cast<uint32_t>(key.event >> 32), key.lumi, key.object}};
+            std::array<uint32_t, 2> k = {{key.run, key.purpose}};
+
+            for (size_t round = 0; round < ROUNDS; round++) {
+                if (round > 0) {
+                    k[0] += W0;
+                    k[1] += W1;
+                }
+
+                uint64_t product0 = static_cast<uint64_t>(M0) * counter[0];
+                uint64_t product1 = static_cast<uint64_t>(M1) * counter[2];
+
+                counter = {{static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ k[0], static_cast<uint32_t>(product1),
+                            static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ k[1], static_cast<uint32_t>(product0)}};
+            }
+
+            return counter;
+        }
+
+        /**
+         * Return two independent doubles uniformly distributed in [0, 1)
+         */
+        static std::array<double, 2> uniform(const RandomKey& key) {
+            result_type r = generate(key);
+            return {{to_double(r[0], r[1]), to_double(r[2], r[3])}};
+        }
+
+        /**
+         * Turn a name into a purpose identifier (32 bits FNV-1a hash). Use a
+         * different name for each independent use of random numbers.
+         */
+        static uint32_t purpose(const std::string& name) {
+            uint32_t hash = 2166136261u;
+            for (unsigned char c: name) {
+                hash ^= c;
+                hash *= 16777619u;
+            }
+
+            return hash;
+        }
+
+    private:
+        static const size_t ROUNDS = 10;
+
+        static const uint32_t M0 = 0xD2511F53;
+        static const uint32_t M1 = 0xCD9E8D57;
+        static const uint32_t W0 = 0x9E3779B9;
+        static const uint32_t W1 = 0xBB67AE85;
+
+        static double to_double(uint32_t high, uint32_t low) {
+            // Keep the 53 most significant bits
+            return ((static_cast<uint64_t>(high) << 32 | low) >> 11) * (1.0 / 9007199254740992.0);
+        }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cp3_llbb/Framework/interface/Filter.h>
+#include <cp3_llbb/Framework/interface/HLTService.h>
+
+#include <DataFormats/Common/interface/TriggerResults.h>
+#include <DataFormats/Provenance/interface/ParameterSetID.h>
+#include <FWCore/Common/interface/TriggerNames.h>
+
+#include <map>
+#include <memory>
+#include <utility>
+
+/**
+ * Remove the events also present in a primary dataset of higher priority, when running over
+ * overlapping datasets (DoubleMuon, MuonEG, SingleMuon, ...).
+ *
+ * Each dataset is given by a list of path patterns (see HLTService). An event of the processed
+ * dataset is kept if it fires one of the paths of this dataset, and none of the paths of the
+ * datasets before it in the priority list. Each event is therefore kept in exactly one dataset.
+ *
+ * If a triggers file is given, only the paths also selected by HLTService for the run are
+ * considered. Only meaningful for data.
+ */
+class DatasetOverlapFilter: public Framework::Filter {
+    public:
+        DatasetOverlapFilter(const std::string& name, const edm::ParameterSet& config);
+
+        virtual ~DatasetOverlapFilter() {}
+
+        virtual void doConsumes(const edm::ParameterSet& config, edm::ConsumesCollector&& collector) override {
+            m_hlt_token = collector.consumes<edm::TriggerResults>(config.getUntrackedParameter<edm::InputTag>("hlt", edm::InputTag("TriggerResults", "", "HLT")));
+        }
+
+        virtual bool filter(edm::Event& event, const edm::EventSetup& eventSetup) override;
+
+        virtual void endJob(MetadataManager& metadata) override;
+
+    private:
+
+        /**
+         * Trigger indices deciding if the event is kept, only built when the menu (identified
+         * by the ParameterSetID of the TriggerNames) or the run range of HLTService change.
+         */
+        struct TriggerMenu {
+            // Paths of the processed dataset only
+            std::vector<size_t> dataset_indices;
+
+            // Paths of the datasets of higher priority
+            std::vector<size_t> veto_indices;
+        };
+
+        const TriggerMenu& getTriggerMenu(const edm::TriggerNames& triggerNames, const HLTService::PathSet* valid_paths);
+
+        // Tokens
+        edm::EDGetTokenT<edm::TriggerResults> m_hlt_token;
+
+        // Service
+        std::shared_ptr<HLTService> m_hlt_service;
+
+        // Paths of the processed dataset
+        HLTService::PathSet m_dataset_paths;
+
+        // Paths of the datasets of higher priority
+        std::vector<HLTService::PathSet> m_veto_paths;
+
+        // Menus already seen, for each set of paths of HLTService (nullptr without HLTService)
+        std::map<std::pair<edm::ParameterSetID, const HLTService::PathSet*>, TriggerMenu> m_menus;
+        const TriggerMenu* m_current_menu = nullptr;
+        std::pair<edm::ParameterSetID, const HLTService::PathSet*> m_current_menu_key;
+
+        // Statistics
+        uint64_t m_processed_events = 0;
+        uint64_t m_duplicated_events = 0;
+        uint64_t m_untriggered_events = 0;
+};
@@ -4,15 +4,18 @@
 #include <cp3_llbb/Framework/interface/LeptonsProducer.h>
 #include <cp3_llbb/Framework/interface/Identifiable.h>
 #include <cp3_llbb/Framework/interface/ScaleFactors.h>
+#include <cp3_llbb/Framework/interface/TriggerMatching.h>
 
 #include <DataFormats/PatCandidates/interface/Electron.h>
 
-class ElectronsProducer: public LeptonsProducer<pat::Electron>, public Identifiable, public ScaleFactors {
+class ElectronsProducer: public LeptonsProducer<pat::Electron>, public Identifiable, public ScaleFactors, public TriggerMatching {
     public:
         ElectronsProducer(const std::string& name, const ROOT::TreeGroup& tree, const edm::ParameterSet& config):
-            LeptonsProducer(name, tree, config), Identifiable(const_cast<ROOT::TreeGroup&>(tree)), ScaleFactors(const_cast<ROOT::TreeGroup&>(tree))
+            LeptonsProducer(name, tree, config), Identifiable(const_cast<ROOT::TreeGroup&>(tree)), ScaleFactors(const_cast<ROOT::TreeGroup&>(tree)),
+            TriggerMatching(const_cast<ROOT::TreeGroup&>(tree))
         {
             ScaleFactors::create_branches(config);
+            TriggerMatching::create_branches(config);
         }
 
         virtual ~ElectronsProducer() {}
@@ -31,6 +34,14 @@ class ElectronsProducer: public LeptonsProducer<pat::Electron>, public Identifia
 
         virtual void produce(edm::Event& event, const edm::EventSetup& eventSetup) override;
 
+        virtual void beforeFill() override {
+            ScaleFactors::evaluate_scale_factors();
+        }
+
+        virtual void endEvent() override {
+            ScaleFactors::clear_scale_factors();
+        }
+
     private:
         // Tokens
         edm::EDGetTokenT<std::vector<reco::Vertex>> m_vertices_token;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Set of events, identified by (run, luminosity block, event), for veto and pick lists.
+ *
+ * Two file formats are supported:
+ *   - Text: one event per line, as 'run:lumi:event' (like the pick-events lists) or with the
+ *     numbers separated by spaces or commas. Empty lines and lines starting with '#' are ignored.
+ *   - Binary, for large lists, as produced by scripts/convertEventListToBinary.py: a Header
+ *     (see below) followed by n_events Entry, in native endianness. Files starting with the
+ *     magic string are read as binary, whatever their extension.
+ *
+ * Entries are stored in a hash table: the entries are grouped by bucket in one array, and the
+ * buckets are a table of offsets into it. With about one entry per bucket, a lookup reads one
+ * offset and a couple of entries. An optional blocked Bloom filter, where all the bits of an
+ * event are in the same cache line, rejects most of the absent events with a single memory
+ * access, which is useful for large veto lists.
+ */
+class EventList {
+    public:
+        static constexpr const char* EXTENSION = ".evl";
+        static constexpr uint32_t VERSION = 1;
+
+        struct Entry {
+            uint32_t run;
+            uint32_t lumi;
+            uint64_t event;
+
+            bool operator==(const Entry& other) const {
+                return event == other.event && run == other.run && lumi == other.lumi;
+            }
+
+            bool operator<(const Entry& other) const {
+                if (run != other.run)
+                    return run < other.run;
+                if (lumi != other.lumi)
+                    return lumi < other.lumi;
+                return event < other.event;
+            }
+        };
+
+        static_assert(sizeof(Entry) == 16, "Unexpected padding in the event list entries");
+
+        struct Header {
+            char magic[8]; // "CP3EVL\0\0"
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t n_events;
+        };
+
+        static_assert(sizeof(Header) == 24, "Unexpected padding in the binary event list header");
+
+        EventList(const std::string& file, bool bloom_filter = false);
+        EventList(std::vector<Entry> entries, bool bloom_filter = false);
+
+        bool contains(uint32_t run, uint32_t lumi, uint64_t event) const;
+
+        // Number of distinct events
+        size_t size() const {
+            return m_entries.size();
+        }
+
+    private:
+        static uint64_t hash(uint32_t run, uint32_t lumi, uint64_t event);
+
+        void parse_text(const std::string& file);
+        void parse_binary(const std::string& file);
+        void build(bool bloom_filter);
+
+        size_t bucket(uint64_t hash) const {
+            return m_bucket_bits ? hash >> (64 - m_bucket_bits) : 0;
+        }
+
+        bool may_contain(uint64_t hash) const;
+
+        // Entries grouped by bucket: the entries of bucket i are m_entries[m_buckets[i]] to m_entries[m_buckets[i + 1]] (excluded)
+        std::vector<Entry> m_entries;
+        std::vector<uint32_t> m_buckets;
+        unsigned m_bucket_bits = 0;
+
+        // Bloom filter, made of blocks of BLOOM_BLOCK_WORDS words. Empty if disabled.
+        std::vector<uint64_t> m_bloom;
+        size_t m_bloom_blocks = 0;
+};
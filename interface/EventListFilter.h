@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cp3_llbb/Framework/interface/Filter.h>
+#include <cp3_llbb/Framework/interface/EventList.h>
+
+#include <memory>
+
+/**
+ * Reject the events of a list (veto mode), or keep only them (keep mode). See EventList for
+ * the supported file formats.
+ */
+class EventListFilter: public Framework::Filter {
+    public:
+        EventListFilter(const std::string& name, const edm::ParameterSet& config);
+
+        virtual ~EventListFilter() {}
+
+        virtual bool filter(edm::Event& event, const edm::EventSetup& eventSetup) override;
+
+        virtual void endJob(MetadataManager& metadata) override;
+
+    private:
+        std::unique_ptr<EventList> m_events;
+
+        // True to keep only the events of the list, false to reject them
+        bool m_keep;
+
+        // Statistics
+        uint64_t m_processed_events = 0;
+        uint64_t m_rejected_events = 0;
+};
@@ -20,7 +20,14 @@ class FatJetsProducer: public CandidatesProducer<pat::Jet>, public BTaggingScale
                 for (const std::string& btag: btags) {
                     std::string branchName{btag};
                     std::replace(std::begin(branchName), std::end(branchName), ':', '_');
-                    m_btag_discriminators.emplace(btag, &CandidatesProducer<pat::Jet>::tree[branchName].write<std::vector<float>>());
+                    auto* branch = &CandidatesProducer<pat::Jet>::tree[branchName].write<std::vector<float>>();
+                    m_btag_discriminators.emplace(btag, branch);
+
+                    Algorithm algo = string_to_algorithm(btag);
+                    if (! BTaggingScaleFactors::has_scale_factors(algo))
+                        algo = Algorithm::UNKNOWN;
+
+                    m_btags.push_back({btag, branch, algo});
                 }
             }
 
@@ -50,6 +57,14 @@ class FatJetsProducer: public CandidatesProducer<pat::Jet>, public BTaggingScale
 
         virtual void produce(edm::Event& event, const edm::EventSetup& eventSetup) override;
 
+        virtual void beforeFill() override {
+            BTaggingScaleFactors::evaluate_scale_factors();
+        }
+
+        virtual void endEvent() override {
+            BTaggingScaleFactors::clear_scale_factors();
+        }
+
         float getBTagDiscriminant(size_t index, const std::string& name) const {
             return m_btag_discriminators.at(name)->at(index);
         }
@@ -70,6 +85,7 @@ class FatJetsProducer: public CandidatesProducer<pat::Jet>, public BTaggingScale
         edm::EDGetTokenT<std::vector<pat::Jet>> m_jets_token;
 
         std::map<std::string, std::vector<float>*> m_btag_discriminators;
+        std::vector<BTagDiscriminator> m_btags;
 
         std::vector<std::string> m_subjets_btag_discriminators;
         std::map<std::string, std::vector<std::vector<float>>*> m_softdrop_btag_discriminators_branches;
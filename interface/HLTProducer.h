@@ -3,12 +3,21 @@
 
 #include <cp3_llbb/Framework/interface/CandidatesProducer.h>
 #include <cp3_llbb/Framework/interface/HLTService.h>
+#include <cp3_llbb/Framework/interface/TriggerMatching.h>
 
 #include <FWCore/Common/interface/TriggerNames.h>
 #include <DataFormats/Common/interface/TriggerResults.h>
 #include <DataFormats/PatCandidates/interface/PackedTriggerPrescales.h>
 #include <DataFormats/PatCandidates/interface/TriggerObjectStandAlone.h>
 
+#include <limits>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+class TTree;
+
 class HLTProducer: public Framework::Producer {
     public:
         HLTProducer(const std::string& name, const ROOT::TreeGroup& tree, const edm::ParameterSet& config):
@@ -20,6 +29,9 @@ class HLTProducer: public Framework::Producer {
                 m_hlt_service->print();
                 std::cout << std::endl;
             }
+
+            if (config.getUntrackedParameter<bool>("prescales_per_lumi", false))
+                createLumiTree();
         }
 
         virtual ~HLTProducer() {}
@@ -32,8 +44,43 @@ class HLTProducer: public Framework::Producer {
 
         virtual void produce(edm::Event& event, const edm::EventSetup& eventSetup) override;
 
+        virtual void beginLuminosityBlock(const edm::LuminosityBlock& lumi, const edm::EventSetup& eventSetup) override {
+            // Prescales can only change at the beginning of a luminosity block
+            m_prescales_menu = nullptr;
+        }
+
+        virtual void endJob(MetadataManager& metadata) override;
+
     private:
 
+        /**
+         * Paths of a trigger menu selected for the output, for a given set of path patterns.
+         * Only built when the menu (identified by the ParameterSetID of the TriggerNames) or
+         * the run range of the patterns change, so no string is involved for most events.
+         */
+        struct TriggerMenu {
+            // For each trigger index, true if the path passes the selection
+            std::vector<bool> selected;
+
+            // Indices of the selected paths, sorted by path name
+            std::vector<size_t> sorted_indices;
+
+            // Path names, indexed by trigger index
+            std::vector<std::string> names;
+
+            // Trigger index of each selected path, to identify the paths of the trigger objects
+            std::unordered_map<std::string, size_t> indices;
+        };
+
+        const TriggerMenu& getTriggerMenu(const edm::TriggerNames& triggerNames, const HLTService::PathSet* valid_paths);
+
+        /**
+         * Read the prescales of the selected paths of @p menu, and store them in the lumi tree if enabled
+         */
+        void updatePrescales(const edm::Event& event, const TriggerMenu& menu);
+
+        void createLumiTree();
+
         // Tokens
         edm::EDGetTokenT<edm::TriggerResults> m_hlt_token;
         edm::EDGetTokenT<pat::PackedTriggerPrescales> m_prescales_token;
@@ -42,12 +89,40 @@ class HLTProducer: public Framework::Producer {
         // Service
         std::shared_ptr<HLTService> m_hlt_service;
 
+        // Menus already seen, for each set of path patterns (nullptr without filtering)
+        std::map<std::pair<edm::ParameterSetID, const HLTService::PathSet*>, TriggerMenu> m_menus;
+        const TriggerMenu* m_current_menu = nullptr;
+        std::pair<edm::ParameterSetID, const HLTService::PathSet*> m_current_menu_key;
+
+        static const uint16_t NOT_ACCEPTED = std::numeric_limits<uint16_t>::max();
+
+        // Position of the accepted paths of the current event in the paths branch, indexed by
+        // trigger index. Only the entries listed in m_accepted_indices differ from NOT_ACCEPTED.
+        std::vector<uint16_t> m_path_positions;
+        std::vector<size_t> m_accepted_indices;
+
+        // Prescales of the selected paths of m_prescales_menu, indexed by trigger index, for
+        // the current luminosity block. nullptr when they must be read again.
+        const TriggerMenu* m_prescales_menu = nullptr;
+        std::vector<uint16_t> m_menu_prescales;
+        bool m_has_prescales = false;
+
+        // With the prescales_per_lumi option, prescales are stored once per luminosity block
+        // and menu in a separate tree, instead of in the prescales branch
+        TTree* m_lumi_tree = nullptr;
+        std::unique_ptr<ROOT::TreeWrapper> m_lumi_wrapper;
+        uint32_t* m_lumi_index = nullptr;
+        uint32_t m_lumi_entries = 0;
+
     public:
         // Tree members
         std::vector<std::string>& paths = tree["paths"].write<std::vector<std::string>>();
+        // Empty with the prescales_per_lumi option
         std::vector<uint16_t>& prescales = tree["prescales"].write<std::vector<uint16_t>>();
 
         BRANCH(object_paths, std::vector<std::vector<std::string>>);
+        // For each object, indices in the paths branch of its paths, in the same order as object_paths
+        BRANCH(object_path_indices, std::vector<std::vector<uint16_t>>);
         TRANSIENT_BRANCH(object_filters, std::vector<std::vector<std::string>>);
         BRANCH(object_p4, std::vector<LorentzVector>);
         BRANCH(object_pdg_id, std::vector<int>);
@@ -1,70 +1,92 @@
 #pragma once
 
+#include <cp3_llbb/Framework/interface/Range.h>
+
 #include <boost/regex.hpp>
+
+#include <cstdint>
+#include <limits>
 #include <map>
+#include <ostream>
+#include <string>
+#include <vector>
 
 namespace tinyxml2 {
     class XMLElement;
 }
 
-template<typename T>
-class Range {
-    public:
-        Range(T from, T to):
-            m_from(from), m_to(to) {}
+class HLTService {
+  public:
 
-        T from() const {
-            return m_from;
-        }
+    using PathName = boost::regex;
+    using PathVector =  std::vector<PathName>;
 
-        T to() const {
-            return m_to;
+    /**
+     * Path patterns of a run range. The patterns are also compiled together into a single
+     * regular expression, so that a path name is matched against all of them in one pass.
+     *
+     * Patterns are case-insensitive, and must not use back-references.
+     */
+    class PathSet {
+      public:
+        static const size_t NO_MATCH = std::numeric_limits<size_t>::max();
+
+        PathSet() = default;
+        PathSet(const PathVector& patterns);
+
+        const PathVector& patterns() const {
+          return m_patterns;
         }
 
-        bool in(T value) const {
-            return value >= m_from && value <= m_to;
-        }
+        /**
+         * Index of the first pattern matching the whole @p name, or NO_MATCH
+         */
+        size_t match(const std::string& name) const;
 
-        bool operator<(const Range<T>& other) const {
-            return m_from < other.m_from;
+        bool matches(const std::string& name) const {
+          return match(name) != NO_MATCH;
         }
 
-        template<typename U>
-            friend std::ostream& operator<<(std::ostream& stream, const Range<U>& range);
-
-    private:
-        T m_from;
-        T m_to;
-};
-
-template<typename T>
-std::ostream& operator<<(std::ostream& stream, const Range<T>& range)
-{
-    stream << "[" << range.from() << ", " << range.to() << "]";
-
-    return stream;
-}
+      private:
+        PathVector m_patterns;
 
-class HLTService {
-  public:
+        // All the patterns, each one enclosed in a marked sub-expression
+        PathName m_combined;
 
-    using PathName = boost::regex;
-    using PathVector =  std::vector<PathName>;
+        // Index of the sub-expression enclosing each pattern in m_combined
+        std::vector<size_t> m_groups;
+    };
 
     HLTService(const std::string& filename):
-      m_cachedRange(nullptr), m_cachedVector(nullptr) {
+      m_cachedRange(nullptr), m_cachedPaths(nullptr) {
         parse(filename);
+        buildIndex();
       }
 
     void print();
-    const PathVector& getPaths(uint64_t run);
+
+    /**
+     * Paths of the run range containing @p run. If several ranges contain @p run, the one
+     * starting first is used.
+     */
+    const PathSet& getPaths(uint64_t run);
 
   private:
-    std::map<Range<uint64_t>, PathVector> m_paths;
+    // Disjoint runs interval, with the paths of the first range containing it
+    struct Interval {
+      Range<uint64_t> runs;
+      const PathSet* paths;
+    };
+
+    std::map<Range<uint64_t>, PathSet> m_paths;
+
+    // Run ranges split into disjoint intervals, sorted by first run
+    std::vector<Interval> m_index;
 
     const Range<uint64_t>* m_cachedRange;
-    const PathVector* m_cachedVector;
+    const PathSet* m_cachedPaths;
 
     bool parse(const std::string& filename);
     bool parseRunsElement(const tinyxml2::XMLElement* runs);
+    void buildIndex();
 };
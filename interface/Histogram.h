@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 template<typename T, typename _Bin = T>
@@ -12,24 +15,35 @@ class Histogram {
         virtual bool inRange(const std::vector<_Bin>& values) = 0;
         virtual std::vector<_Bin> clamp(const std::vector<_Bin>& values) = 0;
 
-        T getBinContent(std::size_t bin) {
+        // Bin edges, one vector per dimension
+        virtual std::vector<std::vector<_Bin>> getBinning() const = 0;
+
+        /**
+         * Clamp @p value to the range covered by the binning along @p axis
+         */
+        _Bin clampAxis(std::size_t axis, _Bin value) const {
+            const auto& range = m_ranges[axis];
+            return std::min(std::max(value, range.first), range.second);
+        }
+
+        const T& getBinContent(std::size_t bin) const {
             return m_values[bin - 1];
         }
-        T getBinErrorLow(std::size_t bin) {
+        const T& getBinErrorLow(std::size_t bin) const {
             return m_errors_low[bin - 1];
         }
-        T getBinErrorHigh(std::size_t bin) {
+        const T& getBinErrorHigh(std::size_t bin) const {
             return m_errors_high[bin - 1];
         }
 
         void setBinContent(std::size_t bin, T value) {
-            m_values[bin - 1] = value;
+            writable()[bin - 1] = value;
         }
         void setBinErrorLow(std::size_t bin, T value) {
-            m_errors_low[bin - 1] = value;
+            writable()[m_size + bin - 1] = value;
         }
         void setBinErrorHigh(std::size_t bin, T value) {
-            m_errors_high[bin - 1] = value;
+            writable()[2 * m_size + bin - 1] = value;
         }
 
         void setContent(const std::vector<_Bin>& values, T content) {
@@ -48,25 +62,44 @@ class Histogram {
         Histogram(std::size_t size) {
             m_size = size;
 
-            m_values.reset(new T[m_size]);
-            m_errors_low.reset(new T[m_size]);
-            m_errors_high.reset(new T[m_size]);
+            std::shared_ptr<T> storage(new T[3 * m_size], std::default_delete<T[]>());
+            m_writable = storage.get();
+            m_values = m_writable;
+            m_errors_low = m_values + m_size;
+            m_errors_high = m_errors_low + m_size;
+
+            m_storage = storage;
         }
 
+        /**
+         * Create an histogram whose content lives in an external buffer (for example a
+         * memory-mapped file). @p storage keeps the buffer alive as long as the histogram exists.
+         * The buffer may be read-only: the setters throw on such an histogram.
+         */
+        Histogram(std::size_t size, const T* values, const T* errors_low, const T* errors_high, std::shared_ptr<const void> storage) {
+            m_size = size;
+
+            m_values = values;
+            m_errors_low = errors_low;
+            m_errors_high = errors_high;
+
+            m_storage = storage;
+        }
+
+        // Edges must be sorted, see BinnedValues::validate_binning
         static size_t findBin(const std::vector<_Bin>& array, _Bin value) {
-            for (std::size_t i = 0; i < array.size() - 1; i++) {
-                if ((value >= array[i]) && (value < array[i + 1]))
-                    return i + 1;
-            }
+            if (!(value >= array.front()) || !(value < array.back()))
+                return 0;
 
-            return 0;
+            return std::upper_bound(array.begin(), array.end(), value) - array.begin();
         }
 
+        // Values below the binning (or NaN) are mapped to the first bin, values above to the last one
         static size_t findClosestBin(const std::vector<_Bin>& array, _Bin value, bool* outOfRange = nullptr) {
             if (outOfRange)
                 *outOfRange = false;
 
-            if (value < array.front()) {
+            if (!(value >= array.front())) {
                 if (outOfRange)
                     *outOfRange = true;
                 return 1;
@@ -99,12 +132,34 @@ class Histogram {
             return value;
         }
 
+        void addAxis(const std::vector<_Bin>& bins) {
+            m_ranges.push_back(std::make_pair(bins.front(), bins.back()));
+        }
+
         std::size_t m_size;
-        std::unique_ptr<T[]> m_values;
-        std::unique_ptr<T[]> m_errors_low;
-        std::unique_ptr<T[]> m_errors_high;
+
+        // Lowest and highest edge of each axis
+        std::vector<std::pair<_Bin, _Bin>> m_ranges;
+
+        const T* m_values;
+        const T* m_errors_low;
+        const T* m_errors_high;
+
+        // Values, low and high errors, one after the other, when the histogram owns its content.
+        // nullptr for an external buffer.
+        T* m_writable = nullptr;
+
+        // Owner of the memory pointed by the arrays above
+        std::shared_ptr<const void> m_storage;
 
     private:
+        T* writable() {
+            if (! m_writable)
+                throw std::logic_error("The content of this histogram is read-only");
+
+            return m_writable;
+        }
+
         Histogram() = delete;
 
 };
@@ -115,6 +170,13 @@ class OneDimensionHistogram: public Histogram<T, _Bin> {
         OneDimensionHistogram(const std::vector<_Bin>& bins):
             Histogram<T, _Bin>(bins.size() - 1) {
                 m_bins = bins;
+                this->addAxis(bins);
+        }
+
+        OneDimensionHistogram(const std::vector<_Bin>& bins, const T* values, const T* errors_low, const T* errors_high, std::shared_ptr<const void> storage):
+            Histogram<T, _Bin>(bins.size() - 1, values, errors_low, errors_high, storage) {
+                m_bins = bins;
+                this->addAxis(bins);
         }
 
         virtual std::size_t findBin(const std::vector<_Bin>& values) override {
@@ -153,6 +215,10 @@ class OneDimensionHistogram: public Histogram<T, _Bin> {
             return {Histogram<T, _Bin>::clamp(m_bins, value)};
         }
 
+        virtual std::vector<std::vector<_Bin>> getBinning() const override {
+            return {m_bins};
+        }
+
     private:
         std::vector<_Bin> m_bins;
 };
@@ -164,6 +230,16 @@ class TwoDimensionsHistogram: public Histogram<T, _Bin> {
             Histogram<T, _Bin>((bins_x.size() - 1) * (bins_y.size() - 1)) {
                 m_bins_x = bins_x;
                 m_bins_y = bins_y;
+                this->addAxis(bins_x);
+                this->addAxis(bins_y);
+        }
+
+        TwoDimensionsHistogram(const std::vector<_Bin>& bins_x, const std::vector<_Bin>& bins_y, const T* values, const T* errors_low, const T* errors_high, std::shared_ptr<const void> storage):
+            Histogram<T, _Bin>((bins_x.size() - 1) * (bins_y.size() - 1), values, errors_low, errors_high, storage) {
+                m_bins_x = bins_x;
+                m_bins_y = bins_y;
+                this->addAxis(bins_x);
+                this->addAxis(bins_y);
         }
 
         virtual std::size_t findBin(const std::vector<_Bin>& values) override {
@@ -237,6 +313,10 @@ class TwoDimensionsHistogram: public Histogram<T, _Bin> {
             return {Histogram<T, _Bin>::clamp(m_bins_x, value_x), Histogram<T, _Bin>::clamp(m_bins_y, value_y)};
         }
 
+        virtual std::vector<std::vector<_Bin>> getBinning() const override {
+            return {m_bins_x, m_bins_y};
+        }
+
     private:
         std::vector<_Bin> m_bins_x;
         std::vector<_Bin> m_bins_y;
@@ -250,6 +330,19 @@ class ThreeDimensionsHistogram: public Histogram<T, _Bin> {
                 m_bins_x = bins_x;
                 m_bins_y = bins_y;
                 m_bins_z = bins_z;
+                this->addAxis(bins_x);
+                this->addAxis(bins_y);
+                this->addAxis(bins_z);
+        }
+
+        ThreeDimensionsHistogram(const std::vector<_Bin>& bins_x, const std::vector<_Bin>& bins_y, const std::vector<_Bin>& bins_z, const T* values, const T* errors_low, const T* errors_high, std::shared_ptr<const void> storage):
+            Histogram<T, _Bin>((bins_x.size() - 1) * (bins_y.size() - 1) * (bins_z.size() - 1), values, errors_low, errors_high, storage) {
+                m_bins_x = bins_x;
+                m_bins_y = bins_y;
+                m_bins_z = bins_z;
+                this->addAxis(bins_x);
+                this->addAxis(bins_y);
+                this->addAxis(bins_z);
         }
 
         virtual std::size_t findBin(const std::vector<_Bin>& values) override {
@@ -284,6 +377,9 @@ class ThreeDimensionsHistogram: public Histogram<T, _Bin> {
             _Bin value_z = values[2];
             bool local_outOfRange = false;
 
+            if (outOfRange)
+                *outOfRange = false;
+
             size_t bin_x = Histogram<T, _Bin>::findClosestBin(m_bins_x, value_x, &local_outOfRange);
 
             if (outOfRange)
@@ -335,6 +431,10 @@ class ThreeDimensionsHistogram: public Histogram<T, _Bin> {
             return {Histogram<T, _Bin>::clamp(m_bins_x, value_x), Histogram<T, _Bin>::clamp(m_bins_y, value_y), Histogram<T, _Bin>::clamp(m_bins_z, value_z)};
         }
 
+        virtual std::vector<std::vector<_Bin>> getBinning() const override {
+            return {m_bins_x, m_bins_y, m_bins_z};
+        }
+
     private:
         std::vector<_Bin> m_bins_x;
         std::vector<_Bin> m_bins_y;
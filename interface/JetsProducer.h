@@ -3,17 +3,19 @@
 
 #include <cp3_llbb/Framework/interface/CandidatesProducer.h>
 #include <cp3_llbb/Framework/interface/BTaggingScaleFactors.h>
+#include <cp3_llbb/Framework/interface/TriggerMatching.h>
 
 #include <DataFormats/PatCandidates/interface/Jet.h>
 #include "TMVA/Reader.h"
 
 
-class JetsProducer: public CandidatesProducer<pat::Jet>, public BTaggingScaleFactors {
+class JetsProducer: public CandidatesProducer<pat::Jet>, public BTaggingScaleFactors, public TriggerMatching {
     public:
         JetsProducer(const std::string& name, const ROOT::TreeGroup& tree, const edm::ParameterSet& config):
-            CandidatesProducer(name, tree, config), BTaggingScaleFactors(const_cast<ROOT::TreeGroup&>(tree))
+            CandidatesProducer(name, tree, config), BTaggingScaleFactors(const_cast<ROOT::TreeGroup&>(tree)), TriggerMatching(const_cast<ROOT::TreeGroup&>(tree))
         {
             BTaggingScaleFactors::create_branches(config);
+            TriggerMatching::create_branches(config);
 
             if (config.exists("btags")) {
                 const std::vector<std::string>& btags = config.getUntrackedParameter<std::vector<std::string>>("btags");
@@ -22,7 +24,14 @@ class JetsProducer: public CandidatesProducer<pat::Jet>, public BTaggingScaleFac
                 for (const std::string& btag: btags) {
                     std::string branchName{btag};
                     std::replace(std::begin(branchName), std::end(branchName), ':', '_');
-                    m_btag_discriminators.emplace(btag, &CandidatesProducer<pat::Jet>::tree[branchName].write<std::vector<float>>());
+                    auto* branch = &CandidatesProducer<pat::Jet>::tree[branchName].write<std::vector<float>>();
+                    m_btag_discriminators.emplace(btag, branch);
+
+                    Algorithm algo = string_to_algorithm(btag);
+                    if (! BTaggingScaleFactors::has_scale_factors(algo))
+                        algo = Algorithm::UNKNOWN;
+
+                    m_btags.push_back({btag, branch, algo});
                 }
             }
             if (config.exists("computeRegression")) {
@@ -63,6 +72,14 @@ class JetsProducer: public CandidatesProducer<pat::Jet>, public BTaggingScaleFac
 
         virtual void produce(edm::Event& event, const edm::EventSetup& eventSetup) override;
 
+        virtual void beforeFill() override {
+            BTaggingScaleFactors::evaluate_scale_factors();
+        }
+
+        virtual void endEvent() override {
+            BTaggingScaleFactors::clear_scale_factors();
+        }
+
 
         float getBTagDiscriminant(size_t index, const std::string& name) const {
             return m_btag_discriminators.at(name)->at(index);
@@ -77,6 +94,7 @@ class JetsProducer: public CandidatesProducer<pat::Jet>, public BTaggingScaleFac
         edm::EDGetTokenT<std::vector<reco::Vertex>> m_vertices_token;
 
         std::map<std::string, std::vector<float>*> m_btag_discriminators;
+        std::vector<BTagDiscriminator> m_btags;
         // regression stuff
         bool computeRegression;
         std::string regressionFile;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cp3_llbb/Framework/interface/Range.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Certified luminosity blocks, as listed in a golden JSON file:
+ *
+ *   {"273158": [[1, 1279]], "273302": [[1, 459], [461, 600]], ...}
+ *
+ * Runs and their luminosity block intervals are stored in flat sorted arrays, and a lookup is
+ * two binary searches.
+ */
+class LumiMask {
+    public:
+        LumiMask() = default;
+        LumiMask(const std::string& filename);
+
+        /**
+         * True if the luminosity block @p lumi of @p run is certified
+         */
+        bool contains(uint64_t run, uint64_t lumi) const;
+
+        size_t runs() const {
+            return m_runs.size();
+        }
+
+        // Number of disjoint luminosity block intervals, over all the runs
+        size_t intervals() const {
+            return m_lumis.size();
+        }
+
+    private:
+        void parse(const std::string& filename);
+
+        // Sorted runs
+        std::vector<uint64_t> m_runs;
+
+        // The intervals of m_runs[i] are m_lumis[m_offsets[i]] to m_lumis[m_offsets[i + 1]] (excluded)
+        std::vector<size_t> m_offsets;
+
+        // Disjoint intervals of each run, sorted
+        std::vector<Range<uint64_t>> m_lumis;
+};
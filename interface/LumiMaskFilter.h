@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cp3_llbb/Framework/interface/Filter.h>
+#include <cp3_llbb/Framework/interface/LumiMask.h>
+
+/**
+ * Reject the luminosity blocks which are not listed in a golden JSON file.
+ *
+ * The decision only changes with the luminosity block, so it is taken in beginLuminosityBlock.
+ * Only meaningful for data.
+ */
+class LumiMaskFilter: public Framework::Filter {
+    public:
+        LumiMaskFilter(const std::string& name, const edm::ParameterSet& config);
+
+        virtual ~LumiMaskFilter() {}
+
+        virtual bool filter(edm::Event& event, const edm::EventSetup& eventSetup) override {
+            return m_certified;
+        }
+
+        virtual void beginLuminosityBlock(const edm::LuminosityBlock& lumi, const edm::EventSetup& eventSetup) override;
+        virtual void endJob(MetadataManager& metadata) override;
+
+    private:
+        LumiMask m_mask;
+
+        // Decision for the current luminosity block
+        bool m_certified = false;
+
+        // Statistics
+        uint64_t m_processed_lumis = 0;
+        uint64_t m_rejected_lumis = 0;
+};
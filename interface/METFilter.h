@@ -2,6 +2,11 @@
 
 #include <cp3_llbb/Framework/interface/Filter.h>
 #include <DataFormats/Common/interface/TriggerResults.h>
+#include <DataFormats/Provenance/interface/ParameterSetID.h>
+#include <FWCore/Common/interface/TriggerNames.h>
+
+#include <limits>
+#include <map>
 
 class METFilter: public Framework::Filter {
     public:
@@ -9,6 +14,8 @@ class METFilter: public Framework::Filter {
             Filter(name, config)
         {
             m_flags = config.getUntrackedParameter<std::vector<std::string>>("flags");
+            m_allow_missing_flags = config.getUntrackedParameter<bool>("allow_missing_flags", true);
+            m_rejections.resize(m_flags.size(), 0);
         }
 
         virtual ~METFilter() {}
@@ -19,10 +26,34 @@ class METFilter: public Framework::Filter {
 
         virtual bool filter(edm::Event& event, const edm::EventSetup& eventSetup) override;
 
+        virtual void endJob(MetadataManager& metadata) override;
+
     private:
 
+        static const size_t NOT_FOUND = std::numeric_limits<size_t>::max();
+
+        /**
+         * Trigger index of each flag, or NOT_FOUND if the flag is not in the menu. Only
+         * resolved when the menu (identified by the ParameterSetID of the TriggerNames) changes.
+         */
+        const std::vector<size_t>& getFlagIndices(const edm::TriggerNames& triggerNames);
+
         // Tokens
         edm::EDGetTokenT<edm::TriggerResults> m_met_filters_token;
 
         std::vector<std::string> m_flags;
+
+        // If true, flags missing from the menu are ignored with a warning instead of raising an error
+        bool m_allow_missing_flags;
+
+        // Menus already seen
+        std::map<edm::ParameterSetID, std::vector<size_t>> m_menus;
+        const std::vector<size_t>* m_current_indices = nullptr;
+        edm::ParameterSetID m_current_menu;
+
+        // Statistics
+        uint64_t m_processed_events = 0;
+        uint64_t m_rejected_events = 0;
+        // Number of events rejected by each flag, in the order of m_flags
+        std::vector<uint64_t> m_rejections;
 };
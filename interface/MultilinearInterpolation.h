@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cp3_llbb/Framework/interface/Histogram.h>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Linear (1D), bilinear (2D) or trilinear (3D) interpolation of the content of an histogram
+ * between its bin centres.
+ *
+ * The grid of bin centres is split in cells, and the coefficients of the multilinear polynomial
+ * describing each cell are computed once, when the values are loaded. Evaluating the value and
+ * the errors then only costs a bin search on each axis and (2^dimension - 1) multiply-adds per
+ * quantity.
+ *
+ * Between the first (last) bin edge and the first (last) bin centre, the values are constant
+ * and equal to the content of the first (last) bin.
+ */
+class MultilinearInterpolation {
+    public:
+        /**
+         * Interpolate the content of @p h. @p extra_errors optionally points to @p n_extra_errors
+         * additional errors for each bin, stored contiguously bin after bin.
+         */
+        MultilinearInterpolation(Histogram<float>& h, const float* extra_errors = nullptr, std::size_t n_extra_errors = 0);
+
+        /**
+         * Interpolated value, low error, high error and extra errors at @p variables, given in
+         * the order of the binning
+         */
+        std::vector<float> evaluate(const std::vector<float>& variables) const;
+
+    private:
+        struct Axis {
+            std::vector<float> centres;
+            // Inverse of the distance between two consecutive centres
+            std::vector<float> inverse_widths;
+            // Number of cells along this axis (at least one, even with a single bin)
+            std::size_t n_cells;
+        };
+
+        std::size_t m_dimension;
+        // Number of coefficients per quantity and per cell
+        std::size_t m_n_corners;
+        // Number of interpolated quantities: value, low and high errors, and the extra errors
+        std::size_t m_n_quantities;
+
+        std::vector<Axis> m_axes;
+
+        // For each cell (x running fastest), the coefficients of each quantity.
+        // Coefficient i multiplies the product of the local coordinates of the axes whose bit is set in i.
+        std::vector<float> m_coefficients;
+};
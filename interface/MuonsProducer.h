@@ -3,18 +3,20 @@
 
 #include <cp3_llbb/Framework/interface/LeptonsProducer.h>
 #include <cp3_llbb/Framework/interface/ScaleFactors.h>
+#include <cp3_llbb/Framework/interface/TriggerMatching.h>
 
 #include <DataFormats/VertexReco/interface/Vertex.h>
 #include <DataFormats/PatCandidates/interface/Muon.h>
 
 #include <utility>
 
-class MuonsProducer: public LeptonsProducer<pat::Muon>, public ScaleFactors {
+class MuonsProducer: public LeptonsProducer<pat::Muon>, public ScaleFactors, public TriggerMatching {
     public:
         MuonsProducer(const std::string& name, const ROOT::TreeGroup& tree, const edm::ParameterSet& config):
-            LeptonsProducer(name, tree, config), ScaleFactors(const_cast<ROOT::TreeGroup&>(tree))
+            LeptonsProducer(name, tree, config), ScaleFactors(const_cast<ROOT::TreeGroup&>(tree)), TriggerMatching(const_cast<ROOT::TreeGroup&>(tree))
         {
             ScaleFactors::create_branches(config);
+            TriggerMatching::create_branches(config);
         }
 
         virtual ~MuonsProducer() {}
@@ -27,6 +29,14 @@ class MuonsProducer: public LeptonsProducer<pat::Muon>, public ScaleFactors {
 
         virtual void produce(edm::Event& event, const edm::EventSetup& eventSetup) override;
 
+        virtual void beforeFill() override {
+            ScaleFactors::evaluate_scale_factors();
+        }
+
+        virtual void endEvent() override {
+            ScaleFactors::clear_scale_factors();
+        }
+
     private:
         // Tokens
         edm::EDGetTokenT<std::vector<reco::Vertex>> m_vertices_token;
@@ -59,6 +59,17 @@ namespace Framework {
              * @sa CMSSW reference manual: https://cmssdt.cern.ch/SDT/doxygen/
              */
             virtual void produce(edm::Event& event, const edm::EventSetup& setup) = 0;
+
+            //! Called right before the output tree is filled
+            /*!
+             * Only called for events which are written to the output tree, after all the analyzers and categories. Override
+             * this method to compute quantities which are only needed in the output tree.
+             */
+            virtual void beforeFill() {}
+
+            //! Called at the end of each event processed by the producers, whether it was written or not
+            virtual void endEvent() {}
+
             //! Hook for the CMSSW consumes interface
             /*!
              * Override this method to register your tokens into the CMSSW framework via the @p collector interface
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ostream>
+
+/**
+ * Closed interval [from, to]. Ranges are ordered by their first value.
+ */
+template<typename T>
+class Range {
+    public:
+        Range(T from, T to):
+            m_from(from), m_to(to) {}
+
+        T from() const {
+            return m_from;
+        }
+
+        T to() const {
+            return m_to;
+        }
+
+        bool in(T value) const {
+            return value >= m_from && value <= m_to;
+        }
+
+        bool operator<(const Range<T>& other) const {
+            return m_from < other.m_from;
+        }
+
+        template<typename U>
+            friend std::ostream& operator<<(std::ostream& stream, const Range<U>& range);
+
+    private:
+        T m_from;
+        T m_to;
+};
+
+template<typename T>
+std::ostream& operator<<(std::ostream& stream, const Range<T>& range)
+{
+    stream << "[" << range.from() << ", " << range.to() << "]";
+
+    return stream;
+}
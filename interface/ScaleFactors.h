@@ -8,7 +8,9 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <map>
 #include <memory>
+#include <vector>
 
 class ScaleFactors {
 
@@ -21,13 +23,59 @@ class ScaleFactors {
         virtual void create_branches(const edm::ParameterSet&) final;
         virtual void create_branch(const std::string& scale_factor, const std::string& branch_name);
 
+        /**
+         * Compute and store the scale-factors of one object. If 'deferred_scale_factors' is
+         * set in the configuration, only the parameters are recorded, and the scale-factors
+         * are computed by evaluate_scale_factors. Until then, the branches stay empty: only
+         * get_scale_factor gives the values.
+         */
         virtual void store_scale_factors(const Parameters&, bool isData) final;
 
+        /**
+         * Compute the scale-factors recorded in deferred mode. Call this before the tree
+         * is filled. Nothing is done if no scale-factors are pending.
+         */
+        virtual void evaluate_scale_factors() final;
+
+        /**
+         * Drop the scale-factors recorded in deferred mode, for events which are not written
+         */
+        virtual void clear_scale_factors() final;
+
         virtual float get_scale_factor(const std::string& tag, size_t index, Variation variation = Variation::Nominal) final;
 
+        /**
+         * Return the down or up error of the uncertainty component @p component of a scale-factor
+         */
+        virtual float get_scale_factor(const std::string& tag, size_t index, const std::string& component, Variation variation) final;
+
     private:
+        struct PendingScaleFactor {
+            Parameters parameters;
+            bool isData;
+        };
+
+        struct RegisteredScaleFactor {
+            const BinnedValues* values;
+            std::vector<std::vector<float>>* branch;
+            std::size_t layout;
+        };
+
+        void compute_scale_factors(const Parameters&, bool isData);
+
+        // Entry @p value of the values stored for object @p index
+        float get_value(const std::string& name, size_t index, size_t value);
+
         ROOT::TreeGroup& m_tree;
 
         std::map<std::string, std::vector<std::vector<float>>*> m_branches;
-        std::map<std::string, std::unique_ptr<BinnedValues>> m_scale_factors;
+        std::map<std::string, std::shared_ptr<const BinnedValues>> m_scale_factors;
+
+        // Scale-factors in evaluation order, grouped by binning layout. For each object,
+        // the bin is only searched once per layout
+        std::vector<RegisteredScaleFactor> m_evaluation_order;
+        BinnedValuesLookupContext m_lookup;
+
+        bool m_deferred = false;
+        std::vector<PendingScaleFactor> m_pending;
 };
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <FWCore/ParameterSet/interface/ParameterSet.h>
+#include <FWCore/ParameterSet/interface/FileInPath.h>
+
+#include <cp3_llbb/Framework/interface/BinnedValues.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Process-wide cache of scale-factors
+ *
+ * Producers cloned for systematics (JEC / JER up and down, ...) usually register the same
+ * scale-factors files. Instead of parsing and holding each file once per producer, every
+ * producer asks the registry, which parses a given file (or a given set of weighted files)
+ * only once and hands out shared instances.
+ *
+ * Returned objects are shared between producers and must never be modified.
+ */
+class ScaleFactorsRegistry {
+    public:
+        static ScaleFactorsRegistry& get();
+
+        /**
+         * Return the scale-factors stored in the JSON file @p file
+         */
+        std::shared_ptr<const BinnedValues> load(const edm::FileInPath& file);
+
+        /**
+         * Return the luminosity-weighted scale-factors described by @p parts. Each
+         * ParameterSet must contain a 'file' and a 'weight' parameter.
+         *
+         * If @p combine is true, the weighted average of the parts is computed once (see
+         * CombinedBinnedValues). Otherwise, one part is sampled for each object (see WeightedBinnedValues).
+         */
+        std::shared_ptr<const BinnedValues> load(const std::vector<edm::ParameterSet>& parts, bool combine = false);
+
+        void print_summary() const;
+
+        ScaleFactorsRegistry(const ScaleFactorsRegistry&) = delete;
+        ScaleFactorsRegistry& operator=(const ScaleFactorsRegistry&) = delete;
+
+    private:
+        typedef std::chrono::steady_clock clock;
+
+        ScaleFactorsRegistry() = default;
+
+        static std::string canonical_path(const std::string& path);
+
+        template <typename Factory>
+        std::shared_ptr<const BinnedValues> get_or_create(const std::string& key, Factory factory);
+
+        mutable std::mutex m_mutex;
+        std::map<std::string, std::shared_ptr<const BinnedValues>> m_scale_factors;
+
+        // Statistics
+        size_t m_requests = 0;
+        clock::duration m_loading_time = clock::duration::zero();
+};
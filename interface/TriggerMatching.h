@@ -0,0 +1,148 @@
+#pragma once
+
+#include <FWCore/ParameterSet/interface/ParameterSet.h>
+#include <DataFormats/Provenance/interface/EventID.h>
+
+#include <cp3_llbb/Framework/interface/HLTService.h>
+#include <cp3_llbb/TreeWrapper/interface/TreeWrapper.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Trigger objects of the current event, as stored by the hlt producer, indexed on an η–φ grid
+ * to match them with offline objects.
+ *
+ * Producers register the filters they need when they are created. For each event, the hlt
+ * producer fills the index with the objects it stores, and the grid of each filter is built
+ * once, the first time the filter is used. Indices of matched objects refer to the hlt_object_*
+ * branches.
+ *
+ * The hlt producer must therefore run before the producers matching objects, which is the
+ * default scheduling.
+ */
+class TriggerObjectsIndex {
+    public:
+        /**
+         * Trigger objects considered for a match. Empty lists do not restrict the objects.
+         */
+        struct Filter {
+            // Absolute values of the pdg ids
+            std::vector<int> pdg_ids;
+
+            // Patterns of the paths (see HLTService), at least one must have been fired by the object
+            std::vector<std::string> paths;
+
+            // At least one of these filter labels must have been passed by the object
+            std::vector<std::string> filter_labels;
+
+            float max_delta_r;
+
+            bool operator==(const Filter& other) const;
+        };
+
+        static TriggerObjectsIndex& get();
+
+        /**
+         * Register a filter, and return its identifier. Identical filters share the same identifier.
+         */
+        std::size_t add_filter(const Filter& filter);
+
+        /**
+         * Start a new event. @p menu is the list of trigger names of the event, and must stay
+         * valid as long as the menu is used.
+         */
+        void reset(const edm::EventID& event, const std::vector<std::string>* menu);
+
+        /**
+         * Add a trigger object, with the trigger indices of its paths
+         */
+        void add_object(float eta, float phi, int pdg_id, const std::vector<std::size_t>& paths, const std::vector<std::string>& filter_labels);
+
+        /**
+         * Index and ΔR of the closest trigger object passing @p filter, or (-1, -1) if none is
+         * within the maximal ΔR of the filter
+         */
+        std::pair<int, float> match(std::size_t filter, const edm::EventID& event, float eta, float phi);
+
+    private:
+        TriggerObjectsIndex() = default;
+        TriggerObjectsIndex(const TriggerObjectsIndex&) = delete;
+        TriggerObjectsIndex& operator=(const TriggerObjectsIndex&) = delete;
+
+        struct Object {
+            float eta;
+            float phi;
+            // Bit i is set if the object passes filter i
+            uint64_t filters;
+        };
+
+        struct FilterData {
+            Filter filter;
+            HLTService::PathSet paths;
+            // Bit of each filter label in the label masks
+            uint64_t filter_labels = 0;
+
+            // For each trigger index of the current menu, true if the path matches the filter
+            const std::vector<std::string>* menu = nullptr;
+            std::vector<bool> menu_paths;
+
+            // Grid of the current event: objects sorted by cell
+            uint64_t generation = 0;
+            std::size_t n_eta;
+            std::size_t n_phi;
+            std::vector<std::pair<uint32_t, uint16_t>> cells;
+        };
+
+        void build_grid(FilterData& data);
+        uint32_t cell(const FilterData& data, std::size_t eta, std::size_t phi) const;
+        std::size_t eta_bin(const FilterData& data, float eta) const;
+        std::size_t phi_bin(const FilterData& data, float phi) const;
+
+        std::vector<FilterData> m_filters;
+
+        // Bit of each filter label used by at least one filter
+        std::unordered_map<std::string, uint64_t> m_filter_labels;
+
+        edm::EventID m_event;
+        // Incremented for each event, to know when the grids are outdated
+        uint64_t m_generation = 0;
+        bool m_filled = false;
+
+        std::vector<Object> m_objects;
+};
+
+/**
+ * Match the objects of a producer to the trigger objects stored by the hlt producer.
+ *
+ * Each entry of the 'trigger_matching' PSet of the configuration creates two branches: hlt_<name>_idx,
+ * the index of the matched trigger object (-1 if none), and hlt_<name>_deltaR, the ΔR between both
+ * objects (-1 if none). See python/MuonsProducer.py for an example.
+ */
+class TriggerMatching {
+    public:
+        TriggerMatching(ROOT::TreeGroup& tree):
+            m_tree(tree) {
+                // Empty
+            }
+
+        virtual void create_branches(const edm::ParameterSet&) final;
+
+        /**
+         * Match one object to the trigger objects of @p event, and store the results
+         */
+        virtual void store_trigger_matches(const edm::EventID& event, float eta, float phi) final;
+
+    private:
+        struct Matcher {
+            std::size_t filter;
+            std::vector<int16_t>* indices;
+            std::vector<float>* delta_r;
+        };
+
+        ROOT::TreeGroup& m_tree;
+        std::vector<Matcher> m_matchers;
+};
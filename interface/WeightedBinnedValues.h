@@ -2,25 +2,79 @@
 
 #include <cp3_llbb/Framework/interface/BinnedValues.h>
 
+#ifndef STANDALONE_SCALEFACTORS
 #include <FWCore/ParameterSet/interface/ParameterSet.h>
+#endif
 
-#include <memory>
-#include <random>
+#include <atomic>
+#include <string>
+#include <utility>
 #include <vector>
 
 class WeightedBinnedValues: public BinnedValues {
     public:
+        // Path of a file, and its weight
+        typedef std::pair<std::string, double> part_type;
+
+        WeightedBinnedValues(const std::vector<part_type>& parts);
+#ifndef STANDALONE_SCALEFACTORS
         WeightedBinnedValues(const std::vector<edm::ParameterSet>& parts);
+#endif
+
+        using BinnedValues::get;
+
         /**
          * Randomly select one set of efficiencies from the ones
          * available, according to the fraction of integrated luminosity used to
          * compute the efficiency. A set of efficiencies evaluated on more luminosity
          * will be sampled more than one evaluated on less
+         *
+         * The selection only depends on the random key of the parameters, so a given
+         * object always gets the same set of efficiencies. Without a random key, successive
+         * calls are used as counter.
          */
         virtual std::vector<float> get(const Parameters&) const override;
 
+        // Each set of efficiencies may have its own binning
+        virtual bool canShareBins() const override {
+            return false;
+        }
+
     private:
-        mutable std::mt19937 random_generator;
-        std::unique_ptr<std::discrete_distribution<int>> probability_distribution;
+        // Cumulative weights, normalized to 1
+        std::vector<double> cumulative_weights;
         std::vector<BinnedValues> efficiencies;
+
+        uint32_t random_purpose;
+        mutable std::atomic<uint64_t> calls_without_key {0};
+};
+
+/**
+ * Luminosity-weighted combination of several sets of values, computed once when the values are
+ * loaded instead of sampling one set per object like WeightedBinnedValues.
+ *
+ * The result is a plain BinnedValues, binned on the union of the bin edges of all the sets. The
+ * content of each bin is the weighted average of the values of each set at the bin centre. Errors
+ * (total and components) are converted to absolute errors and averaged the same way, ie. they are
+ * considered fully correlated between the sets, like scripts/computeWeightedAverage.py does.
+ * Where the range of a set is narrower than the common binning, its closest bin is used, with
+ * its errors unchanged: errors are only doubled outside the range of the common binning.
+ *
+ * All sets must be binned (no formula) on the same variables, with the same uncertainty components.
+ * Interpolated sets must also have the same binning: the interpolation of the combined values is
+ * then exactly the weighted average of the interpolated values of each set.
+ */
+class CombinedBinnedValues {
+    public:
+        CombinedBinnedValues(const std::vector<WeightedBinnedValues::part_type>& parts);
+#ifndef STANDALONE_SCALEFACTORS
+        CombinedBinnedValues(const std::vector<edm::ParameterSet>& parts);
+#endif
+
+        virtual BinnedValues&& get_values() final {
+            return std::move(m_values);
+        }
+
+    private:
+        BinnedValues m_values;
 };
@@ -0,0 +1,183 @@
+"""
+Vectorized evaluation of scale-factors files from python, using numpy arrays.
+
+Values are computed by the C++ code of the framework (see interface/BinnedValuesC.h), so results are
+identical to the content of the sf_* branches.
+
+Usage:
+
+    from cp3_llbb.Framework.BinnedValues import BinnedValues
+
+    sf = BinnedValues('data/ScaleFactors/Muon_TightID_genTracks_id_BCDEFGH_weighted.json')
+    nominal, up, down = sf.evaluate(pt=muons_pt, eta=muons_eta)
+
+'up' and 'down' are the absolute errors on the nominal value. Files may also split the errors into
+uncertainty components, listed in 'sf.components':
+
+    for name, (down, up) in sf.evaluate_components(pt=muons_pt, eta=muons_eta).items():
+        ...
+
+The shared library is searched for in this order: the 'library' argument, the BINNEDVALUES_LIBRARY
+environment variable, the package library of the current CMSSW area, the libBinnedValues.so built by
+Makefile.libBinnedValues or CMakeLists.txt, and the system library path.
+"""
+
+from __future__ import print_function
+
+import ctypes
+import ctypes.util
+import os
+
+import numpy as np
+
+ERROR_SIZE = 1024
+
+_float_p = ctypes.POINTER(ctypes.c_float)
+
+def _candidate_libraries():
+    if 'BINNEDVALUES_LIBRARY' in os.environ:
+        yield os.environ['BINNEDVALUES_LIBRARY']
+
+    if 'CMSSW_BASE' in os.environ and 'SCRAM_ARCH' in os.environ:
+        yield os.path.join(os.environ['CMSSW_BASE'], 'lib', os.environ['SCRAM_ARCH'], 'libcp3_llbbFramework.so')
+
+    package_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+    yield os.path.join(package_dir, 'libBinnedValues.so')
+    yield os.path.join(package_dir, 'build', 'libBinnedValues.so')
+
+    library = ctypes.util.find_library('BinnedValues')
+    if library:
+        yield library
+
+_library = None
+
+def _load_library(path=None):
+    global _library
+
+    if path:
+        return _setup(ctypes.CDLL(path))
+
+    if _library:
+        return _library
+
+    for candidate in _candidate_libraries():
+        if os.path.isabs(candidate) and not os.path.exists(candidate):
+            continue
+        try:
+            _library = _setup(ctypes.CDLL(candidate))
+            return _library
+        except OSError:
+            continue
+
+    raise OSError('Cannot find the BinnedValues library. Build it with CMakeLists.txt or Makefile.libBinnedValues, or set BINNEDVALUES_LIBRARY')
+
+def _setup(library):
+    library.binned_values_load.restype = ctypes.c_void_p
+    library.binned_values_load.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_size_t]
+
+    library.binned_values_free.restype = None
+    library.binned_values_free.argtypes = [ctypes.c_void_p]
+
+    library.binned_values_evaluate.restype = ctypes.c_int
+    library.binned_values_evaluate.argtypes = [ctypes.c_void_p, ctypes.c_size_t, _float_p, _float_p, _float_p,
+            _float_p, _float_p, _float_p, ctypes.c_char_p, ctypes.c_size_t]
+
+    library.binned_values_n_components.restype = ctypes.c_size_t
+    library.binned_values_n_components.argtypes = [ctypes.c_void_p]
+
+    library.binned_values_component_name.restype = ctypes.c_char_p
+    library.binned_values_component_name.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+
+    library.binned_values_evaluate_components.restype = ctypes.c_int
+    library.binned_values_evaluate_components.argtypes = [ctypes.c_void_p, ctypes.c_size_t, _float_p, _float_p, _float_p,
+            _float_p, ctypes.c_char_p, ctypes.c_size_t]
+
+    return library
+
+def _as_pointer(array):
+    if array is None:
+        return None
+    return array.ctypes.data_as(_float_p)
+
+def _prepare_inputs(pt, eta, discri):
+    """
+    Broadcast the inputs against each other, and convert them to contiguous float32 arrays.
+    Return the broadcast shape and the flattened inputs.
+    """
+
+    inputs = [x for x in (pt, eta, discri) if x is not None]
+    if not inputs:
+        raise ValueError('At least one of pt, eta or discri is needed')
+
+    broadcast = np.broadcast_arrays(*inputs)
+    shape = broadcast[0].shape
+    converted = iter([np.ascontiguousarray(x, dtype=np.float32).ravel() for x in broadcast])
+
+    return (shape,) + tuple(next(converted) if x is not None else None for x in (pt, eta, discri))
+
+class BinnedValues(object):
+    """
+    Scale-factors loaded from a JSON (or binary) file
+    """
+
+    def __init__(self, file, library=None):
+        self.__library = _load_library(library)
+
+        error = ctypes.create_string_buffer(ERROR_SIZE)
+        self.__handle = self.__library.binned_values_load(file.encode('utf-8'), error, ERROR_SIZE)
+        if not self.__handle:
+            raise ValueError('Failed to load %s: %s' % (file, error.value.decode('utf-8')))
+
+        self.components = [self.__library.binned_values_component_name(self.__handle, i).decode('utf-8')
+                for i in range(self.__library.binned_values_n_components(self.__handle))]
+
+    def __del__(self):
+        handle = getattr(self, '_BinnedValues__handle', None)
+        if handle:
+            self.__library.binned_values_free(handle)
+
+    def evaluate(self, pt=None, eta=None, discri=None):
+        """
+        Evaluate the scale-factors for all the objects at once. Inputs are broadcast against each
+        other, and converted to float32 like in the framework. Variables not needed by the file
+        can be omitted.
+
+        Return a tuple of three float32 arrays: nominal values, up errors and down errors.
+        """
+
+        shape, pt, eta, discri = _prepare_inputs(pt, eta, discri)
+
+        n = int(np.prod(shape))
+        nominal = np.empty(n, dtype=np.float32)
+        up = np.empty(n, dtype=np.float32)
+        down = np.empty(n, dtype=np.float32)
+
+        error = ctypes.create_string_buffer(ERROR_SIZE)
+        status = self.__library.binned_values_evaluate(self.__handle, n, _as_pointer(pt), _as_pointer(eta), _as_pointer(discri),
+                _as_pointer(nominal), _as_pointer(up), _as_pointer(down), error, ERROR_SIZE)
+        if status != 0:
+            raise ValueError(error.value.decode('utf-8'))
+
+        return nominal.reshape(shape), up.reshape(shape), down.reshape(shape)
+
+    def evaluate_components(self, pt=None, eta=None, discri=None):
+        """
+        Evaluate the uncertainty components for all the objects at once. Inputs are handled like
+        in evaluate().
+
+        Return a dictionary mapping the name of each component to a tuple of two float32 arrays:
+        down errors and up errors.
+        """
+
+        shape, pt, eta, discri = _prepare_inputs(pt, eta, discri)
+
+        n = int(np.prod(shape))
+        components = np.empty((n, len(self.components), 2), dtype=np.float32)
+
+        error = ctypes.create_string_buffer(ERROR_SIZE)
+        status = self.__library.binned_values_evaluate_components(self.__handle, n, _as_pointer(pt), _as_pointer(eta), _as_pointer(discri),
+                _as_pointer(components), error, ERROR_SIZE)
+        if status != 0:
+            raise ValueError(error.value.decode('utf-8'))
+
+        return dict((name, (components[:, i, 0].reshape(shape), components[:, i, 1].reshape(shape))) for i, name in enumerate(self.components))
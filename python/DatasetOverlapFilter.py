@@ -0,0 +1,23 @@
+import FWCore.ParameterSet.Config as cms
+
+# Only for data. Set 'dataset' to the primary dataset being processed. Events are kept in the
+# first dataset of 'priorities' whose paths they fire.
+default_configuration = cms.PSet(
+        type = cms.string('dataset_overlap'),
+        enable = cms.bool(True),
+        parameters = cms.PSet(
+            hlt = cms.untracked.InputTag('TriggerResults', '', 'HLT'),
+            dataset = cms.untracked.string(''),
+            priorities = cms.untracked.vstring('DoubleMuon', 'DoubleEG', 'MuonEG', 'SingleMuon', 'SingleElectron'),
+            # Path patterns of each dataset, see HLTService
+            datasets = cms.untracked.PSet(
+                DoubleMuon = cms.untracked.vstring('HLT_Mu17_TrkIsoVVL_(Tk)?Mu8_TrkIsoVVL_(DZ_)?v.*'),
+                DoubleEG = cms.untracked.vstring('HLT_Ele23_Ele12_CaloIdL_TrackIdL_IsoVL_(DZ_)?v.*'),
+                MuonEG = cms.untracked.vstring('HLT_Mu(8|12|23)_TrkIsoVVL_Ele(8|12|23)_CaloIdL_TrackIdL_IsoVL_(DZ_)?v.*'),
+                SingleMuon = cms.untracked.vstring('HLT_Iso(Tk)?Mu24_v.*'),
+                SingleElectron = cms.untracked.vstring('HLT_Ele27_WPTight_Gsf_v.*')
+                ),
+            # Optional: only consider the paths also selected for the run in a triggers file
+            # triggers = cms.untracked.FileInPath('cp3_llbb/Framework/data/triggers.xml')
+            )
+        )
@@ -8,6 +8,8 @@ default_configuration = cms.PSet(
             src = cms.untracked.InputTag('slimmedElectrons'),
             ea_R03 = cms.untracked.FileInPath('RecoEgamma/ElectronIdentification/data/Summer16/effAreaElectrons_cone03_pfNeuHadronsAndPhotons_80X.txt'),
             ea_R04 = cms.untracked.FileInPath('cp3_llbb/Framework/data/effAreaElectrons_cone04_pfNeuHadronsAndPhotons.txt'),
+            # Match electrons to the trigger objects stored by the hlt producer. See MuonsProducer.py
+            trigger_matching = cms.untracked.PSet(),
             ids = cms.untracked.VInputTag(
                 'egmGsfElectronIDs:cutBasedElectronID-Summer16-80X-V1-veto',
                 'egmGsfElectronIDs:cutBasedElectronID-Summer16-80X-V1-loose',
@@ -22,6 +24,13 @@ default_configuration = cms.PSet(
                 values = cms.untracked.InputTag('electronMVAValueMapProducer:ElectronMVAEstimatorRun2Spring16GeneralPurposeV1Values'),
                 categories = cms.untracked.InputTag('electronMVAValueMapProducer:ElectronMVAEstimatorRun2Spring16GeneralPurposeV1Categories')
             ),
+            # If True, scale-factors are only computed for events written to the output tree.
+            # The scale-factor branches are then still empty when the analyzers run: analyzers
+            # must read the scale-factors with get_scale_factor(), which computes them first.
+            deferred_scale_factors = cms.untracked.bool(False),
+            # Scale-factors given as a list of weighted files (cms.untracked.VPSet of 'file' and 'weight'):
+            # 'sample' picks one file per object, 'combine' averages the files once when they are loaded
+            weighted_scale_factors = cms.untracked.string('sample'),
             scale_factors = cms.untracked.PSet(
                 id_veto_moriond17 = cms.untracked.FileInPath('cp3_llbb/Framework/data/ScaleFactors/Electron_EGamma_SF2D_veto_moriond17.json'),
                 id_loose_moriond17 = cms.untracked.FileInPath('cp3_llbb/Framework/data/ScaleFactors/Electron_EGamma_SF2D_loose_moriond17.json'),
@@ -0,0 +1,15 @@
+import FWCore.ParameterSet.Config as cms
+
+# Set 'file' to a text ('run:lumi:event' per line) or binary event list, see interface/EventList.h.
+# Large text lists can be converted to the binary format with scripts/convertEventListToBinary.py.
+default_configuration = cms.PSet(
+        type = cms.string('event_list'),
+        enable = cms.bool(True),
+        parameters = cms.PSet(
+            file = cms.untracked.string(''),
+            # 'veto' to reject the events of the list, 'keep' to keep only them
+            mode = cms.untracked.string('veto'),
+            # Reject most of the events not in the list with a single memory access. Useful for large veto lists.
+            bloom_filter = cms.untracked.bool(False)
+            )
+        )
@@ -185,6 +185,17 @@ class Framework(object):
         self.analyzers.insert(index, name)
         setattr(self.process.framework.analyzers, name, configuration)
 
+    @dep(before=("create", "correction"))
+    def addFilter(self, name, configuration):
+        """
+        Add a filter in the framework configuration with a given name and configuration
+        """
+
+        if hasattr(self.process.framework.filters, name):
+            raise Exception('A filter named %r is already added to the configuration' % name)
+
+        setattr(self.process.framework.filters, name, configuration)
+
     @dep(before=("create", "correction"))
     def addProducer(self, name, configuration, index=None):
         """
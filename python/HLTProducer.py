@@ -6,6 +6,9 @@ default_configuration = cms.PSet(
         enable = cms.bool(True),
         parameters = cms.PSet(
             hlt = cms.untracked.InputTag('TriggerResults', '', 'HLT'),
-            triggers = cms.untracked.FileInPath('cp3_llbb/Framework/data/triggers.xml')
+            triggers = cms.untracked.FileInPath('cp3_llbb/Framework/data/triggers.xml'),
+            # If True, prescales are stored once per luminosity block in the 'hlt_lumis' tree instead of for each event,
+            # and the hlt_lumi_index branch gives the entry of the event in this tree
+            prescales_per_lumi = cms.untracked.bool(False)
             )
         )
@@ -13,6 +13,22 @@ default_configuration = cms.PSet(
             jets = cms.untracked.InputTag('slimmedJets'),
             cut = cms.untracked.string("pt > 10"),
             btags = cms.untracked.vstring('pfCombinedInclusiveSecondaryVertexV2BJetTags', 'pfCombinedMVAV2BJetTags', *discriminators_deepFlavour),
+            # Match jets to the trigger objects stored by the hlt producer. See MuonsProducer.py
+            trigger_matching = cms.untracked.PSet(),
+            # If True, scale-factors are only computed for events written to the output tree.
+            # The scale-factor branches are then still empty when the analyzers run: analyzers
+            # must read the scale-factors with get_scale_factor(), which computes them first.
+            deferred_scale_factors = cms.untracked.bool(False),
+            # If False, per-jet b-tagging scale-factors are not written to the output tree. Useful if only
+            # the per-event weights are needed. To compute per-event weights for a working point, add to its PSet:
+            #   event_weight = cms.untracked.PSet(
+            #       discriminator_cut = cms.untracked.double(0.8484),
+            #       efficiencies = cms.untracked.VPSet(
+            #           cms.untracked.PSet(flavor = cms.untracked.string('bjets'), file = cms.untracked.FileInPath('...')),
+            #           ... one for each flavor, in the same format as the scale-factors
+            #           )
+            #       )
+            store_jet_scale_factors = cms.untracked.bool(True),
             scale_factors = cms.untracked.PSet(
                 csvv2_loose = cms.untracked.PSet(
                     algorithm = cms.untracked.string('csvv2'),
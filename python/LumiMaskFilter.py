@@ -0,0 +1,13 @@
+import FWCore.ParameterSet.Config as cms
+
+# Only for data. Set 'json' to the golden JSON file, for example:
+#   configuration = copy.deepcopy(LumiMaskFilter.default_configuration)
+#   configuration.parameters.json = '/path/to/Cert_271036-284044_13TeV_23Sep2016ReReco_Collisions16_JSON.txt'
+#   framework.addFilter('lumi_mask', configuration)
+default_configuration = cms.PSet(
+        type = cms.string('lumi_mask'),
+        enable = cms.bool(True),
+        parameters = cms.PSet(
+            json = cms.untracked.string('')
+            )
+        )
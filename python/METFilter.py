@@ -5,7 +5,11 @@ default_configuration = cms.PSet(
         enable = cms.bool(True),
         parameters = cms.PSet(
             flags = cms.untracked.vstring('Flag_HBHENoiseFilter', 'Flag_HBHENoiseIsoFilter', 'Flag_globalTightHalo2016Filter', 'Flag_EcalDeadCellTriggerPrimitiveFilter', 'Flag_goodVertices', 'Flag_eeBadScFilter', 'Flag_BadChargedCandidateFilter', 'Flag_BadPFMuonFilter'),
-            filters = cms.untracked.InputTag('TriggerResults', '', 'PAT')
+            filters = cms.untracked.InputTag('TriggerResults', '', 'PAT'),
+            # Flags missing from the trigger results are ignored with a warning. On 80X MiniAOD,
+            # Flag_BadChargedCandidateFilter and Flag_BadPFMuonFilter are not in the PAT trigger
+            # results: they must be run on the fly. Set to False to make missing flags an error.
+            allow_missing_flags = cms.untracked.bool(True)
             )
         )
 
@@ -8,6 +8,22 @@ default_configuration = cms.PSet(
             src = cms.untracked.InputTag('slimmedMuons'),
             ea_R03 = cms.untracked.FileInPath('cp3_llbb/Framework/data/effAreaMuons_cone03_pfNeuHadronsAndPhotons.txt'),
             ea_R04 = cms.untracked.FileInPath('cp3_llbb/Framework/data/effAreaMuons_cone04_pfNeuHadronsAndPhotons.txt'),
+            # If True, scale-factors are only computed for events written to the output tree.
+            # The scale-factor branches are then still empty when the analyzers run: analyzers
+            # must read the scale-factors with get_scale_factor(), which computes them first.
+            deferred_scale_factors = cms.untracked.bool(False),
+            # Scale-factors given as a list of weighted files (cms.untracked.VPSet of 'file' and 'weight'):
+            # 'sample' picks one file per object, 'combine' averages the files once when they are loaded
+            weighted_scale_factors = cms.untracked.string('sample'),
+            # Match muons to the trigger objects stored by the hlt producer. Each entry creates the
+            # hlt_<name>_idx and hlt_<name>_deltaR branches, for example:
+            #   single_muon = cms.untracked.PSet(
+            #       pdg_id = cms.untracked.vint32(13),                  # Absolute values, all objects if empty
+            #       paths = cms.untracked.vstring('HLT_IsoMu24_v.*'),   # Patterns, among the paths selected by the hlt producer
+            #       filters = cms.untracked.vstring(),                  # Filter labels, at least one must be passed
+            #       max_delta_r = cms.untracked.double(0.3)
+            #       )
+            trigger_matching = cms.untracked.PSet(),
             scale_factors = cms.untracked.PSet(
                 tracking = cms.untracked.FileInPath('cp3_llbb/Framework/data/ScaleFactors/Muon_tracking_BCDEFGH.json'),
                 id_loose  = cms.untracked.FileInPath('cp3_llbb/Framework/data/ScaleFactors/Muon_LooseID_genTracks_id_BCDEFGH_weighted.json'),
@@ -0,0 +1,75 @@
+#!/usr/bin/env python
+
+"""
+Convert text event lists ('run:lumi:event' per line) into the binary format loaded by EventList.
+
+Loading a binary list avoids parsing millions of lines at the beginning of each job.
+See interface/EventList.h for a description of the format.
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+MAGIC = b'CP3EVL\0\0'
+VERSION = 1
+EXTENSION = '.evl'
+
+# Must match EventList::Header and EventList::Entry
+HEADER_FORMAT = '=8s2IQ'
+ENTRY_FORMAT = '=2IQ'
+
+def get_options():
+    """
+    Parse and return the arguments provided by the user
+    """
+    parser = argparse.ArgumentParser(description='Convert text event lists into binary files loadable by the framework')
+    parser.add_argument('files', type=str, nargs='+', metavar='FILE',
+        help='Text event lists to convert')
+    parser.add_argument('-o', '--output', type=str, default=None,
+        help='Output directory. By default, binary files are written next to the text files')
+    return parser.parse_args()
+
+def read_events(text_file):
+    """
+    Return the sorted list of distinct (run, lumi, event) of a text event list
+    """
+    events = set()
+    with open(text_file) as f:
+        for line_number, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+
+            fields = [field for field in re.split(r'[\s:,]+', line) if field]
+            if len(fields) != 3 or not all(field.isdigit() for field in fields):
+                raise ValueError('Invalid event at line %d of %s: %r' % (line_number, text_file, line))
+
+            events.add(tuple(int(field) for field in fields))
+
+    return sorted(events)
+
+def convert(text_file, output_file):
+    events = read_events(text_file)
+
+    with open(output_file, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, 0, len(events)))
+        for event in events:
+            f.write(struct.pack(ENTRY_FORMAT, *event))
+
+    return len(events)
+
+def main(options):
+    for text_file in options.files:
+        output_dir = options.output if options.output else os.path.dirname(text_file)
+        output_file = os.path.join(output_dir, os.path.splitext(os.path.basename(text_file))[0] + EXTENSION)
+
+        n_events = convert(text_file, output_file)
+        print('%s -> %s (%d events)' % (text_file, output_file, n_events))
+
+if __name__ == '__main__':
+    sys.exit(main(get_options()))
@@ -0,0 +1,156 @@
+#!/usr/bin/env python
+
+"""
+Convert scale-factors JSON files into the binary format loaded by BinnedValuesBinaryParser.
+
+The binary files are memory-mapped by the framework, which makes loading them almost free.
+See interface/BinnedValuesBinaryParser.h for a description of the format.
+"""
+
+from __future__ import print_function
+
+import argparse
+import bisect
+import json
+import os
+import struct
+import sys
+
+MAGIC = b'CP3SFB\0\0'
+VERSION = 3
+EXTENSION = '.sfb'
+
+FLOAT_MAX = 3.4028234663852886e+38
+
+ERROR_TYPES = {'absolute': 0, 'relative': 1, 'variated': 2}
+FORMULA_VARIABLES = {'x': 0, 'y': 1, 'z': 2}
+INTERPOLATIONS = {'none': 0, 'linear': 1}
+
+# Must match BinnedValuesBinaryParser::Header
+HEADER_FORMAT = '=8s6I2f16s16s16s5I'
+
+def get_options():
+    """
+    Parse and return the arguments provided by the user
+    """
+    parser = argparse.ArgumentParser(description='Convert scale-factors JSON files into binary files loadable by the framework')
+    parser.add_argument('files', type=str, nargs='+', metavar='FILE',
+        help='JSON files to convert')
+    parser.add_argument('-o', '--output', type=str, default=None,
+        help='Output directory. By default, binary files are written next to the JSON files')
+    return parser.parse_args()
+
+def pad(data):
+    return data + b'\0' * (-len(data) % 4)
+
+def pack_string(string):
+    string = string.encode('ascii')
+    return struct.pack('=I', len(string)) + pad(string)
+
+def find_bin(edges, value):
+    """
+    Return the 0-based index of the bin containing value, or -1 if outside the binning
+    """
+    index = bisect.bisect_right(edges, value) - 1
+    if index < 0 or index >= len(edges) - 1:
+        return -1
+
+    return index
+
+def iterate_bins(content, dimension, centers=()):
+    """
+    Yield a tuple (bin centers, bin content) for each bin found in the 'data' section
+    """
+    for entry in content:
+        center = (entry['bin'][0] + entry['bin'][1]) / 2.
+        if len(centers) + 1 < dimension:
+            for b in iterate_bins(entry['values'], dimension, centers + (center,)):
+                yield b
+        else:
+            yield centers + (center,), entry
+
+def convert(json_file, output_file):
+    with open(json_file) as f:
+        content = json.load(f)
+
+    dimension = content.get('dimension', 1)
+    variables = content['variables']
+    if len(variables) != dimension:
+        raise ValueError('Invalid number of variables in %s. Expected %d, got %d' % (json_file, dimension, len(variables)))
+
+    binning = [[float(x) for x in content['binning'][axis]] for axis in ('x', 'y', 'z')[:dimension]]
+
+    n_bins = 1
+    for edges in binning:
+        n_bins *= len(edges) - 1
+
+    formula = content.get('formula', False)
+    formula_variable_index = FORMULA_VARIABLES[content['variable']] if formula else 0
+
+    error_type = ERROR_TYPES[content['error_type'].lower()]
+    interpolation = INTERPOLATIONS[content.get('interpolation', 'none').lower()]
+
+    components = content.get('components', [])
+    if components and formula:
+        raise ValueError('Uncertainty components are not supported with formulas in %s' % json_file)
+
+    # Bins missing from the JSON file are written as NaN, or as empty formulas, and rejected by
+    # the framework when the binary file is loaded, like the JSON parser does
+    values = [float('nan')] * n_bins if not formula else [''] * n_bins
+    errors_low = list(values)
+    errors_high = list(values)
+    component_errors = [float('nan')] * (2 * len(components) * n_bins)
+
+    for centers, entry in iterate_bins(content['data'], dimension):
+        index = 0
+        stride = 1
+        for edges, center in zip(binning, centers):
+            b = find_bin(edges, center)
+            if b < 0:
+                raise ValueError('Bin centered on %r is outside the binning in %s' % (centers, json_file))
+            index += b * stride
+            stride *= len(edges) - 1
+
+        values[index] = entry['value']
+        errors_low[index] = entry['error_low']
+        errors_high[index] = entry['error_high']
+
+        for i, component in enumerate(components):
+            offset = 2 * (index * len(components) + i)
+            component_errors[offset] = entry['components'][component]['error_low']
+            component_errors[offset + 1] = entry['components'][component]['error_high']
+
+    names = [v.encode('ascii') for v in variables] + [b''] * (3 - dimension)
+    n_edges = [len(edges) for edges in binning] + [0] * (3 - dimension)
+
+    data = struct.pack(HEADER_FORMAT, MAGIC, VERSION, dimension, int(formula), formula_variable_index, error_type, interpolation,
+            float(content.get('minimum', 0)), float(content.get('maximum', FLOAT_MAX)),
+            names[0], names[1], names[2], n_edges[0], n_edges[1], n_edges[2], n_bins, len(components))
+
+    for edges in binning:
+        data += struct.pack('=%df' % len(edges), *edges)
+
+    for component in components:
+        data += pack_string(component)
+
+    if not formula:
+        for array in (values, errors_low, errors_high, component_errors):
+            data += struct.pack('=%df' % len(array), *array)
+    else:
+        for expressions in zip(values, errors_low, errors_high):
+            for expression in expressions:
+                data += pack_string(expression)
+
+    with open(output_file, 'wb') as f:
+        f.write(data)
+
+def main(options):
+    for json_file in options.files:
+        output_dir = options.output if options.output else os.path.dirname(json_file)
+        output_file = os.path.join(output_dir, os.path.splitext(os.path.basename(json_file))[0] + EXTENSION)
+
+        convert(json_file, output_file)
+        print('%s -> %s' % (json_file, output_file))
+
+if __name__ == '__main__':
+    sys.exit(main(get_options()))
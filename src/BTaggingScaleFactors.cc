@@ -1,15 +1,22 @@
 #include <cp3_llbb/Framework/interface/BTaggingScaleFactors.h>
-#include <cp3_llbb/Framework/interface/BinnedValuesJSONParser.h>
-#include <cp3_llbb/Framework/interface/WeightedBinnedValues.h>
+#include <cp3_llbb/Framework/interface/ScaleFactorsRegistry.h>
 
 #include <iostream>
 
 //#define SF_DEBUG
 
+const std::size_t BTaggingScaleFactors::N_ALGORITHMS;
+const std::size_t BTaggingScaleFactors::N_FLAVORS;
+
 std::array<SystFlavor, 2> BTaggingScaleFactors::SystFlavors = {{SystFlavor::HEAVY, SystFlavor::LIGHT}};
 
 void BTaggingScaleFactors::create_branches(const edm::ParameterSet& config) {
 
+    m_deferred = config.getUntrackedParameter<bool>("deferred_scale_factors", false);
+
+    // If false, per-jet scale-factors are still computed, but not written to the output tree
+    bool store_jet_scale_factors = config.getUntrackedParameter<bool>("store_jet_scale_factors", true);
+
     if (config.existsAs<edm::ParameterSet>("scale_factors", false)) {
 #ifdef SF_DEBUG
         std::cout << "B-tagging scale factors: " << std::endl;
@@ -32,14 +39,46 @@ void BTaggingScaleFactors::create_branches(const edm::ParameterSet& config) {
 
             std::string wp = scale_factor_set.getUntrackedParameter<std::string>("working_point");
 
-            m_algos[algo].push_back(wp);
+            WorkingPoint working_point;
+            working_point.name = wp;
 
             std::vector<edm::ParameterSet> files = scale_factor_set.getUntrackedParameter<std::vector<edm::ParameterSet>>("files");
 
             for (auto syst_flavor: SystFlavors) {
                 std::string branch_name = "sf_" + algo_str + "_" + syst_flavor_to_string(syst_flavor) + "_" + wp;
-                branch_key_type branch_key = std::make_tuple(algo, syst_flavor, wp);
-                m_branches.emplace(branch_key, & m_tree[branch_name].write<std::vector<std::vector<float>>>());
+                working_point.branches[static_cast<size_t>(syst_flavor) - 1] = store_jet_scale_factors ?
+                    & m_tree[branch_name].write<std::vector<std::vector<float>>>() :
+                    & m_tree[branch_name].transient_write<std::vector<std::vector<float>>>();
+            }
+
+            if (scale_factor_set.existsAs<edm::ParameterSet>("event_weight", false)) {
+                const edm::ParameterSet& event_weight_set = scale_factor_set.getUntrackedParameterSet("event_weight");
+                EventWeight& event_weight = working_point.event_weight;
+
+                event_weight.enabled = true;
+                event_weight.discriminator_cut = event_weight_set.getUntrackedParameter<double>("discriminator_cut");
+                event_weight.reset();
+
+                for (auto syst_flavor: SystFlavors) {
+                    std::string branch_name = "btag_weight_" + algo_str + "_" + syst_flavor_to_string(syst_flavor) + "_" + wp;
+                    event_weight.branches[static_cast<size_t>(syst_flavor) - 1] = & m_tree[branch_name].write<std::vector<float>>();
+                }
+
+                for (auto& file_set: event_weight_set.getUntrackedParameter<std::vector<edm::ParameterSet>>("efficiencies")) {
+                    std::string flavor = file_set.getUntrackedParameter<std::string>("flavor");
+                    const auto& file = file_set.getUntrackedParameter<edm::FileInPath>("file");
+
+                    std::cout << "    Registering new b-tagging efficiency for algo: " << algo_str << "  wp: " << wp << "  flavor: " << flavor << std::endl;
+
+                    ScaleFactor& efficiency = event_weight.efficiencies[static_cast<size_t>(string_to_flavor(flavor))];
+                    efficiency.values = ScaleFactorsRegistry::get().load(file);
+                    efficiency.layout = m_lookup.add_layout(*efficiency.values);
+                }
+
+                for (const auto& efficiency: event_weight.efficiencies) {
+                    if (! efficiency.values)
+                        throw edm::Exception(edm::errors::Configuration, "Event weight for working point " + wp + " needs b-tagging efficiencies for all flavors.");
+                }
             }
 
             for (auto& file_set: files) {
@@ -47,62 +86,176 @@ void BTaggingScaleFactors::create_branches(const edm::ParameterSet& config) {
 
                 std::cout << "    Registering new scale-factor for algo: " << algo_str << "  wp: " << wp << "  flavor: " << flavor;
 
-                sf_key_type sf_key = std::make_tuple(algo, string_to_flavor(flavor), wp);
+                ScaleFactor& sf = working_point.scale_factors[static_cast<size_t>(string_to_flavor(flavor))];
 
                 // The value can be either a FileInPath for a standard JSON file, or a vector
                 // of ParameterSet for weighted values
                 if (file_set.existsAs<edm::FileInPath>("file", false)) {
-                    std::string file = file_set.getUntrackedParameter<edm::FileInPath>("file").fullPath();
+                    const auto& file = file_set.getUntrackedParameter<edm::FileInPath>("file");
                     std::cout << " -> non-weighted." << std::endl;
 
-                    BinnedValuesJSONParser parser(file);
-                    m_scale_factors.emplace(sf_key, std::unique_ptr<BinnedValues>(new BinnedValues(std::move(parser.get_values()))));
+                    sf.values = ScaleFactorsRegistry::get().load(file);
                 } else {
                     const auto& parts = file_set.getUntrackedParameter<std::vector<edm::ParameterSet>>("file");
-                    std::unique_ptr<BinnedValues> values(new WeightedBinnedValues(parts));
-                    m_scale_factors.emplace(sf_key, std::move(values));
+                    sf.values = ScaleFactorsRegistry::get().load(parts);
                     std::cout << " -> weighted (" << parts.size() << " components)." << std::endl;
                 }
+
+                sf.layout = m_lookup.add_layout(*sf.values);
             }
+
+            for (auto syst_flavor: SystFlavors) {
+                auto& unit_values = working_point.unit_values[static_cast<size_t>(syst_flavor) - 1];
+                unit_values = {1., 0., 0.};
+                for (auto flavor: {Flavor::B, Flavor::C, Flavor::LIGHT}) {
+                    const auto& sf = working_point.scale_factors[static_cast<size_t>(flavor)];
+                    if (sf.values && flavor_to_syst_flavor(flavor) == syst_flavor) {
+                        unit_values = sf.values->getUnitValues();
+                        break;
+                    }
+                }
+            }
+
+            m_working_points[static_cast<size_t>(algo)].push_back(std::move(working_point));
         }
 #ifdef SF_DEBUG
+        std::cout << "\tScale-factors sharing " << m_lookup.size() << " binning layouts" << std::endl;
         std::cout << std::endl;
 #endif
     }
 
 }
 
-void BTaggingScaleFactors::store_scale_factors(Algorithm algo_, Flavor flavor, const Parameters& parameters, bool isData) {
+void BTaggingScaleFactors::store_scale_factors(Algorithm algo, Flavor flavor, const Parameters& parameters, bool isData) {
 
-    auto algo_it = m_algos.find(algo_);
-    if (algo_it == m_algos.end())
+    if (! has_scale_factors(algo))
         throw edm::Exception(edm::errors::NotFound, "No scale factors for this algorithm. Please check your python configuration.");
 
-    SystFlavor jet_syst_flavor = flavor_to_syst_flavor(flavor);
-    for (const auto& wp: algo_it->second) {
-        sf_key_type sf_key = std::make_tuple(algo_, flavor, wp);
-        for (auto syst_flavor: SystFlavors) {
-            branch_key_type branch_key = std::make_tuple(algo_, syst_flavor, wp);
+    if (m_deferred)
+        m_pending.push_back({algo, flavor, parameters, isData});
+    else
+        compute_scale_factors(algo, flavor, parameters, isData);
+}
+
+void BTaggingScaleFactors::store_event_weights() {
+    if (m_deferred)
+        m_event_weights_pending = true;
+    else
+        compute_event_weights();
+}
+
+void BTaggingScaleFactors::evaluate_scale_factors() {
+    // Jets must be evaluated in order to keep the branches aligned with the other ones
+    for (const auto& pending: m_pending)
+        compute_scale_factors(pending.algo, pending.flavor, pending.parameters, pending.isData);
+
+    m_pending.clear();
+
+    if (m_event_weights_pending) {
+        compute_event_weights();
+        m_event_weights_pending = false;
+    }
+}
+
+void BTaggingScaleFactors::clear_scale_factors() {
+    m_pending.clear();
+    m_event_weights_pending = false;
 
+    for (auto& working_points: m_working_points) {
+        for (auto& wp: working_points)
+            wp.event_weight.reset();
+    }
+}
+
+void BTaggingScaleFactors::compute_event_weights() {
+    for (auto& working_points: m_working_points) {
+        for (auto& wp: working_points) {
+            EventWeight& event_weight = wp.event_weight;
+            if (! event_weight.enabled)
+                continue;
+
+            for (size_t syst_flavor = 0; syst_flavor < event_weight.branches.size(); syst_flavor++) {
+                const auto& weights = event_weight.weights[syst_flavor];
+                event_weight.branches[syst_flavor]->assign(weights.begin(), weights.end());
+            }
+
+            event_weight.reset();
+        }
+    }
+}
+
+void BTaggingScaleFactors::compute_scale_factors(Algorithm algo, Flavor flavor, const Parameters& parameters, bool isData) {
+
+    m_lookup.set_parameters(parameters);
+
+    size_t jet_flavor = static_cast<size_t>(flavor);
+    size_t jet_syst_flavor = static_cast<size_t>(flavor_to_syst_flavor(flavor)) - 1;
+    for (auto& wp: m_working_points[static_cast<size_t>(algo)]) {
+        for (size_t syst_flavor = 0; syst_flavor < wp.branches.size(); syst_flavor++) {
             // Store a dummy SF for data or if the jet flavor is not the right one
             if (isData || syst_flavor != jet_syst_flavor)
-                (*m_branches[branch_key]).push_back({1., 0., 0.});
-            else
-                (*m_branches[branch_key]).push_back(m_scale_factors.at(sf_key)->get(parameters));
+                wp.branches[syst_flavor]->push_back(wp.unit_values[syst_flavor]);
+            else {
+                const auto& sf = wp.scale_factors[jet_flavor];
+                if (! sf.values)
+                    throw edm::Exception(edm::errors::NotFound, "No " + flavor_to_string(flavor) + " scale factors for working point " + wp.name + ". Please check your python configuration.");
+
+                wp.branches[syst_flavor]->push_back(m_lookup.get(*sf.values, sf.layout));
+            }
+        }
+
+        EventWeight& event_weight = wp.event_weight;
+        if (isData || ! event_weight.enabled)
+            continue;
+
+        const auto& scale_factor = wp.branches[jet_syst_flavor]->back();
+        const auto& efficiency_values = event_weight.efficiencies[jet_flavor];
+        float efficiency = m_lookup.get(*efficiency_values.values, efficiency_values.layout)[Nominal];
+
+        // The jet does not change the weight if the efficiency is meaningless
+        if (efficiency <= 0 || efficiency >= 1)
+            continue;
+
+        bool tagged = parameters.get(BinningVariable::BTagDiscri) >= event_weight.discriminator_cut;
+
+        std::array<double, 3> factors;
+        for (auto variation: {Nominal, Down, Up}) {
+            double sf = scale_factor[Nominal];
+            if (variation == Up)
+                sf += scale_factor[Up];
+            else if (variation == Down)
+                sf -= scale_factor[Down];
+
+            factors[variation] = tagged ? sf : (1 - sf * efficiency) / (1 - efficiency);
+        }
+
+        // Only the scale-factors of the jets of a given syst flavor are varied for its weights
+        for (size_t syst_flavor = 0; syst_flavor < event_weight.weights.size(); syst_flavor++) {
+            auto& weights = event_weight.weights[syst_flavor];
+            for (size_t variation = 0; variation < weights.size(); variation++)
+                weights[variation] *= factors[syst_flavor == jet_syst_flavor ? variation : Nominal];
         }
     }
 }
 
 float BTaggingScaleFactors::get_scale_factor(Algorithm algo, Flavor flavor, const std::string& wp, size_t index, Variation variation/* = Variation::Nominal*/) {
 
-    branch_key_type key = std::make_tuple(algo, flavor_to_syst_flavor(flavor), wp);
-    auto sf = m_branches.find(key);
+    // Analyzers may need the scale-factors before the event is written
+    evaluate_scale_factors();
 
-    if (sf == m_branches.end())
+    if (algo == Algorithm::UNKNOWN)
         return 0;
 
-    if (index >= sf->second->size())
-        return 0;
+    for (const auto& working_point: m_working_points[static_cast<size_t>(algo)]) {
+        if (working_point.name != wp)
+            continue;
+
+        const auto& branch = *working_point.branches[static_cast<size_t>(flavor_to_syst_flavor(flavor)) - 1];
+        if (index >= branch.size())
+            return 0;
+
+        return branch[index][static_cast<size_t>(variation)];
+    }
 
-    return (*sf->second)[index][static_cast<size_t>(variation)];
+    return 0;
 }
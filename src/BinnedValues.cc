@@ -1,72 +1,117 @@
 #include <cp3_llbb/Framework/interface/BinnedValues.h>
 
+#include <algorithm>
+#include <cmath>
+
 #ifndef STANDALONE_SCALEFACTORS
 #include <FWCore/Utilities/interface/EDMException.h>
 #endif
 
-Parameters::Parameters(Parameters&& rhs) {
-    m_values = std::move(rhs.m_values);
+namespace {
+    [[noreturn]] void invalid(const std::string& file, const std::string& message) {
+        std::string full_message{"Invalid scale-factors in " + file + ": " + message};
+#ifdef STANDALONE_SCALEFACTORS
+        throw std::logic_error(full_message);
+#else
+        throw edm::Exception(edm::errors::LogicError, full_message);
+#endif
+    }
+
+    /**
+     * Human readable description of bin @p bin (1-based, x running fastest)
+     */
+    std::string describe_bin(const std::vector<std::vector<float>>& binning, std::size_t bin) {
+        std::stringstream description;
+
+        std::size_t index = bin - 1;
+        for (std::size_t d = 0; d < binning.size(); d++) {
+            std::size_t n_bins = binning[d].size() - 1;
+            std::size_t i = index % n_bins;
+            index /= n_bins;
+
+            if (d > 0)
+                description << " x ";
+            description << "[" << binning[d][i] << ", " << binning[d][i + 1] << "]";
+        }
+
+        return description.str();
+    }
 }
 
-Parameters::Parameters(std::initializer_list<typename value_type::value_type> init) {
+const std::size_t Parameters::N_VARIABLES;
+
+Parameters::Parameters(std::initializer_list<value_type> init) {
     for (auto& i: init) {
         set(i.first, i.second);
     }
 }
 
 Parameters& Parameters::setPt(float pt) {
-    m_values[BinningVariable::Pt] = pt;
-    return *this;
+    return set(BinningVariable::Pt, pt);
 }
 
 Parameters& Parameters::setEta(float eta) {
-    m_values[BinningVariable::Eta] = eta;
-    m_values[BinningVariable::AbsEta] = fabs(eta);
-    return *this;
+    return set(BinningVariable::Eta, eta);
 }
 
 Parameters& Parameters::setBTagDiscri(float d) {
-    m_values[BinningVariable::BTagDiscri] = d;
-    return *this;
+    return set(BinningVariable::BTagDiscri, d);
 }
 
 Parameters& Parameters::set(const BinningVariable& bin, float value) {
-    m_values.emplace(bin, value);
+    std::size_t index = static_cast<std::size_t>(bin);
+    m_values[index] = value;
+    m_is_set[index] = true;
 
     // Special case for eta
     if (bin == BinningVariable::Eta) {
-        m_values.emplace(BinningVariable::AbsEta, std::abs(value));
+        set(BinningVariable::AbsEta, std::abs(value));
     }
 
     return *this;
 }
 
-Parameters& Parameters::set(const typename value_type::value_type& value) {
+Parameters& Parameters::set(const value_type& value) {
     set(value.first, value.second);
     return *this;
 }
 
-std::vector<float> Parameters::toArray(const std::vector<BinningVariable>& binning) const {
-    std::vector<float> values;
-    for (const auto& bin: binning) {
-        const auto& it = m_values.find(bin);
-        if (it == m_values.cend()) {
-            std::string message{"Parametrisation depends on '" +
-                    BinnedValues::variable_to_string_mapping.left.at(bin) +
-                    "' but no value for this parameter has been specified. Please call the appropriate 'set' function of the Parameters object"};
+Parameters& Parameters::setRandomKey(const RandomKey& key) {
+    m_random_key = key;
+    m_has_random_key = true;
+
+    return *this;
+}
+
+float Parameters::get(const BinningVariable& bin) const {
+    std::size_t index = static_cast<std::size_t>(bin);
+    if (! m_is_set[index]) {
+        std::string message{"Parametrisation depends on '" +
+                BinnedValues::variable_to_string_mapping.left.at(bin) +
+                "' but no value for this parameter has been specified. Please call the appropriate 'set' function of the Parameters object"};
 #ifdef STANDALONE_SCALEFACTORS
-            throw std::invalid_argument(message);
+        throw std::invalid_argument(message);
 #else
-            throw edm::Exception(edm::errors::NotFound, message);
+        throw edm::Exception(edm::errors::NotFound, message);
 #endif
-        }
+    }
 
-        values.push_back(it->second);
-    } 
+    return m_values[index];
+}
+
+std::vector<float> Parameters::toArray(const std::vector<BinningVariable>& binning) const {
+    std::vector<float> values;
+    toArray(binning, values);
 
     return values;
 }
 
+void Parameters::toArray(const std::vector<BinningVariable>& binning, std::vector<float>& values) const {
+    values.resize(binning.size());
+    for (std::size_t i = 0; i < binning.size(); i++)
+        values[i] = get(binning[i]);
+}
+
 const BinnedValues::mapping_bimap BinnedValues::variable_to_string_mapping = {
     {BinningVariable::Pt, "Pt"}, {BinningVariable::Eta, "Eta"},
     {BinningVariable::AbsEta, "AbsEta"}, {BinningVariable::BTagDiscri, "BTagDiscri"}
@@ -84,3 +129,110 @@ void BinnedValues::setVariables(const std::vector<std::string>& v) {
         binning_variables.push_back(it->second);
     }
 }
+
+void BinnedValues::validate_binning(const std::vector<float>& edges, const std::string& file) {
+    if (edges.size() < 2)
+        invalid(file, "a binning needs at least two edges");
+
+    for (std::size_t i = 0; i < edges.size(); i++) {
+        if (! std::isfinite(edges[i]))
+            invalid(file, "bin edges must be finite");
+
+        if (i > 0 && !(edges[i] > edges[i - 1]))
+            invalid(file, "bin edges must be strictly increasing");
+    }
+}
+
+void BinnedValues::validate(const std::string& file) const {
+    if (!use_formula && !binned.get())
+        invalid(file, "no binned values");
+
+    if (use_formula && !formula.get())
+        invalid(file, "no formulas");
+
+    std::vector<std::vector<float>> binning = getBinning();
+    if (binning.size() != binning_variables.size())
+        invalid(file, "the number of variables does not match the dimension of the binning");
+
+    for (const auto& edges: binning)
+        validate_binning(edges, file);
+
+    if (std::isnan(minimum) || std::isnan(maximum) || minimum > maximum)
+        invalid(file, "the minimum must be lower than the maximum");
+
+    if (use_formula) {
+        if (formula_variable_index >= binning.size())
+            invalid(file, "the formula variable is not one of the binning variables");
+
+        for (std::size_t bin = 1; bin <= formula->size(); bin++) {
+            if (! formula->getBinContent(bin) || ! formula->getBinErrorLow(bin) || ! formula->getBinErrorHigh(bin))
+                invalid(file, "no formula for bin " + describe_bin(binning, bin));
+        }
+
+        return;
+    }
+
+    // Missing bins are filled with NaN by the parsers
+    for (std::size_t bin = 1; bin <= binned->size(); bin++) {
+        bool finite = std::isfinite(binned->getBinContent(bin)) && std::isfinite(binned->getBinErrorLow(bin)) && std::isfinite(binned->getBinErrorHigh(bin));
+
+        const float* errors = component_errors + (bin - 1) * 2 * components.size();
+        for (std::size_t i = 0; i < 2 * components.size(); i++)
+            finite &= std::isfinite(errors[i]);
+
+        if (! finite)
+            invalid(file, "bin " + describe_bin(binning, bin) + " is missing, or its content is not finite");
+    }
+}
+
+std::vector<std::vector<float>> BinnedValues::getBinning() const {
+    if (!use_formula && binned.get())
+        return binned->getBinning();
+
+    if (use_formula && formula.get())
+        return formula->getBinning();
+
+    return {};
+}
+
+bool BinnedValues::hasSameBinning(const BinnedValues& other) const {
+    if (!canShareBins() || !other.canShareBins())
+        return false;
+
+    return (binning_variables == other.binning_variables) && (getBinning() == other.getBinning());
+}
+
+const std::size_t BinnedValuesLookupContext::NO_LAYOUT;
+
+std::size_t BinnedValuesLookupContext::add_layout(const BinnedValues& values) {
+    if (! values.canShareBins())
+        return NO_LAYOUT;
+
+    for (std::size_t i = 0; i < m_layouts.size(); i++) {
+        if (m_layouts[i]->hasSameBinning(values))
+            return i;
+    }
+
+    m_layouts.push_back(&values);
+    m_bins.resize(m_layouts.size());
+    m_resolved.resize(m_layouts.size(), false);
+
+    return m_layouts.size() - 1;
+}
+
+void BinnedValuesLookupContext::set_parameters(const Parameters& parameters) {
+    m_parameters = &parameters;
+    std::fill(m_resolved.begin(), m_resolved.end(), false);
+}
+
+std::vector<float> BinnedValuesLookupContext::get(const BinnedValues& values, std::size_t layout) {
+    if (layout == NO_LAYOUT)
+        return values.get(*m_parameters);
+
+    if (! m_resolved[layout]) {
+        values.resolve(*m_parameters, m_bins[layout]);
+        m_resolved[layout] = true;
+    }
+
+    return values.get(m_bins[layout]);
+}
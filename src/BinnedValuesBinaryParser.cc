@@ -0,0 +1,224 @@
+#include <cp3_llbb/Framework/interface/BinnedValuesBinaryParser.h>
+
+#ifndef STANDALONE_SCALEFACTORS
+#include <FWCore/Utilities/interface/EDMException.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[8] = {'C', 'P', '3', 'S', 'F', 'B', '\0', '\0'};
+
+    [[noreturn]] void fail(const std::string& message) {
+#ifdef STANDALONE_SCALEFACTORS
+        throw std::runtime_error(message);
+#else
+        throw edm::Exception(edm::errors::FileReadError, message);
+#endif
+    }
+
+    /**
+     * Read-only view of the mapped file, with bound checks
+     */
+    class Reader {
+        public:
+            Reader(const char* data, size_t size, const std::string& file):
+                m_data(data), m_size(size), m_file(file) {
+                // Empty
+            }
+
+            template <typename T>
+            const T* read(size_t count) {
+                size_t length = count * sizeof(T);
+                if (m_offset + length > m_size)
+                    fail("Unexpected end of file while reading " + m_file);
+
+                const T* result = reinterpret_cast<const T*>(m_data + m_offset);
+                m_offset += align(length);
+
+                return result;
+            }
+
+            std::string read_string() {
+                uint32_t length = *read<uint32_t>(1);
+                const char* chars = read<char>(length);
+
+                return std::string(chars, length);
+            }
+
+        private:
+            static size_t align(size_t length) {
+                return (length + 3) & ~static_cast<size_t>(3);
+            }
+
+            const char* m_data;
+            size_t m_size;
+            const std::string& m_file;
+            size_t m_offset = 0;
+    };
+}
+
+bool BinnedValuesBinaryParser::is_binary_file(const std::string& file) {
+    size_t length = std::strlen(EXTENSION);
+    return file.size() >= length && file.compare(file.size() - length, length, EXTENSION) == 0;
+}
+
+void BinnedValuesBinaryParser::parse_file(const std::string& file) {
+
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        fail("Failed to open " + file + ": " + std::strerror(errno));
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0) {
+        close(fd);
+        fail("Failed to stat " + file + ": " + std::strerror(errno));
+    }
+
+    size_t size = file_stat.st_size;
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+        fail("Failed to map " + file + ": " + std::strerror(errno));
+
+    // The mapping lives as long as one histogram points into it
+    std::shared_ptr<const void> storage(mapping, [size](const void* p) { munmap(const_cast<void*>(p), size); });
+
+    Reader reader(static_cast<const char*>(mapping), size, file);
+
+    const Header& header = *reader.read<Header>(1);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        fail(file + " is not a binary scale-factors file");
+
+    if (header.version != VERSION)
+        fail("Unsupported version " + std::to_string(header.version) + " for " + file + ". Please regenerate it with scripts/convertScaleFactorsToBinary.py");
+
+    size_t dimension = header.dimension;
+    if (dimension < 1 || dimension > 3)
+        fail("Invalid dimension " + std::to_string(dimension) + " in " + file);
+
+    std::vector<std::string> variables;
+    for (size_t i = 0; i < dimension; i++)
+        variables.push_back(std::string(header.variables[i], strnlen(header.variables[i], sizeof(header.variables[i]))));
+
+    m_values.setVariables(variables);
+
+    std::vector<float> binning[3];
+    size_t n_bins = 1;
+    for (size_t i = 0; i < dimension; i++) {
+        const float* edges = reader.read<float>(header.n_edges[i]);
+        binning[i].assign(edges, edges + header.n_edges[i]);
+
+        BinnedValues::validate_binning(binning[i], file);
+        n_bins *= header.n_edges[i] - 1;
+    }
+
+    if (n_bins != header.n_bins)
+        fail("Inconsistent number of bins in " + file);
+
+    for (size_t i = 0; i < header.n_components; i++)
+        m_values.components.push_back(reader.read_string());
+
+    switch (header.error_type) {
+        case 0:
+            m_values.error_type = BinnedValues::ErrorType::ABSOLUTE;
+            break;
+
+        case 1:
+            m_values.error_type = BinnedValues::ErrorType::RELATIVE;
+            break;
+
+        case 2:
+            m_values.error_type = BinnedValues::ErrorType::VARIATED;
+            break;
+
+        default:
+            fail("Invalid error type in " + file);
+    }
+
+    m_values.minimum = header.minimum;
+    m_values.maximum = header.maximum;
+    m_values.use_formula = header.formula != 0;
+
+    if (header.interpolation > 1 || (header.interpolation != 0 && m_values.use_formula))
+        fail("Invalid interpolation in " + file);
+
+    if (header.n_components != 0 && m_values.use_formula)
+        fail("Uncertainty components are not supported with formulas in " + file);
+
+    if (! m_values.use_formula) {
+        const float* values = reader.read<float>(n_bins);
+        const float* errors_low = reader.read<float>(n_bins);
+        const float* errors_high = reader.read<float>(n_bins);
+
+        if (header.n_components != 0) {
+            m_values.component_errors = reader.read<float>(2 * header.n_components * n_bins);
+            m_values.component_storage = storage;
+        }
+
+        switch (dimension) {
+            case 1:
+                m_values.binned.reset(new OneDimensionHistogram<float>(binning[0], values, errors_low, errors_high, storage));
+                break;
+
+            case 2:
+                m_values.binned.reset(new TwoDimensionsHistogram<float>(binning[0], binning[1], values, errors_low, errors_high, storage));
+                break;
+
+            case 3:
+                m_values.binned.reset(new ThreeDimensionsHistogram<float>(binning[0], binning[1], binning[2], values, errors_low, errors_high, storage));
+                break;
+        }
+
+        m_values.validate(file);
+
+        if (header.interpolation == 1)
+            m_values.interpolation.reset(new MultilinearInterpolation(*m_values.binned, m_values.component_errors, 2 * m_values.components.size()));
+
+        return;
+    }
+
+    if (header.formula_variable_index >= dimension)
+        fail("Invalid formula variable in " + file);
+
+    m_values.formula_variable_index = header.formula_variable_index;
+
+    switch (dimension) {
+        case 1:
+            m_values.formula.reset(new OneDimensionHistogram<std::shared_ptr<TFormula>, float>(binning[0]));
+            break;
+
+        case 2:
+            m_values.formula.reset(new TwoDimensionsHistogram<std::shared_ptr<TFormula>, float>(binning[0], binning[1]));
+            break;
+
+        case 3:
+            m_values.formula.reset(new ThreeDimensionsHistogram<std::shared_ptr<TFormula>, float>(binning[0], binning[1], binning[2]));
+            break;
+    }
+
+    auto& h = *m_values.formula;
+    for (size_t bin = 1; bin <= n_bins; bin++) {
+        std::string value = reader.read_string();
+        std::string error_low = reader.read_string();
+        std::string error_high = reader.read_string();
+
+        // Bins missing from the JSON file are stored as empty expressions, and reported by validate()
+        if (value.empty() || error_low.empty() || error_high.empty())
+            continue;
+
+        h.setBinContent(bin, std::make_shared<TFormula>("", value.c_str()));
+        h.setBinErrorLow(bin, std::make_shared<TFormula>("", error_low.c_str()));
+        h.setBinErrorHigh(bin, std::make_shared<TFormula>("", error_high.c_str()));
+    }
+
+    m_values.validate(file);
+}
@@ -0,0 +1,105 @@
+#include <cp3_llbb/Framework/interface/BinnedValuesC.h>
+
+#include <cp3_llbb/Framework/interface/BinnedValues.h>
+#include <cp3_llbb/Framework/interface/BinnedValuesBinaryParser.h>
+#include <cp3_llbb/Framework/interface/BinnedValuesJSONParser.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <string>
+
+struct BinnedValuesHandle {
+    BinnedValues values;
+};
+
+namespace {
+    void set_error(const std::string& message, char* error, size_t error_size) {
+        if (! error || error_size == 0)
+            return;
+
+        std::strncpy(error, message.c_str(), error_size - 1);
+        error[error_size - 1] = '\0';
+    }
+
+    Parameters& set_parameters(Parameters& parameters, size_t i, const float* pt, const float* eta, const float* discri) {
+        if (pt)
+            parameters.setPt(pt[i]);
+        if (eta)
+            parameters.setEta(eta[i]);
+        if (discri)
+            parameters.setBTagDiscri(discri[i]);
+
+        return parameters;
+    }
+}
+
+BinnedValuesHandle* binned_values_load(const char* file, char* error, size_t error_size) {
+    try {
+        if (BinnedValuesBinaryParser::is_binary_file(file)) {
+            BinnedValuesBinaryParser parser(file);
+            return new BinnedValuesHandle {std::move(parser.get_values())};
+        }
+
+        BinnedValuesJSONParser parser(file);
+        return new BinnedValuesHandle {std::move(parser.get_values())};
+    } catch (const std::exception& e) {
+        set_error(e.what(), error, error_size);
+    }
+
+    return nullptr;
+}
+
+void binned_values_free(BinnedValuesHandle* values) {
+    delete values;
+}
+
+int binned_values_evaluate(const BinnedValuesHandle* values, size_t n, const float* pt, const float* eta, const float* discri,
+        float* nominal, float* up, float* down, char* error, size_t error_size) {
+
+    try {
+        Parameters parameters;
+        for (size_t i = 0; i < n; i++) {
+            std::vector<float> result = values->values.get(set_parameters(parameters, i, pt, eta, discri));
+            nominal[i] = result[Nominal];
+            up[i] = result[Up];
+            down[i] = result[Down];
+        }
+    } catch (const std::exception& e) {
+        set_error(e.what(), error, error_size);
+        return 1;
+    }
+
+    return 0;
+}
+
+size_t binned_values_n_components(const BinnedValuesHandle* values) {
+    return values->values.getComponents().size();
+}
+
+const char* binned_values_component_name(const BinnedValuesHandle* values, size_t index) {
+    const auto& components = values->values.getComponents();
+    if (index >= components.size())
+        return nullptr;
+
+    return components[index].c_str();
+}
+
+int binned_values_evaluate_components(const BinnedValuesHandle* values, size_t n, const float* pt, const float* eta, const float* discri,
+        float* components, char* error, size_t error_size) {
+
+    size_t n_errors = 2 * values->values.getComponents().size();
+
+    try {
+        Parameters parameters;
+        for (size_t i = 0; i < n; i++) {
+            std::vector<float> result = values->values.get(set_parameters(parameters, i, pt, eta, discri));
+            std::copy(result.begin() + componentIndex(0, Down), result.end(), components + i * n_errors);
+        }
+    } catch (const std::exception& e) {
+        set_error(e.what(), error, error_size);
+        return 1;
+    }
+
+    return 0;
+}
@@ -2,6 +2,9 @@
 
 #include <cp3_llbb/Framework/interface/BinnedValuesJSONParser.h>
 
+#include <algorithm>
+#include <limits>
+
 #ifndef STANDALONE_SCALEFACTORS
 #include <FWCore/Utilities/interface/EDMException.h>
 #endif
@@ -32,6 +35,12 @@ void BinnedValuesJSONParser::parse_file(const std::string& file) {
     if (dimension > 2)
         binning_z = get_array(ptree.get_child("binning.z"));
 
+    BinnedValues::validate_binning(binning_x, file);
+    if (dimension > 1)
+        BinnedValues::validate_binning(binning_y, file);
+    if (dimension > 2)
+        BinnedValues::validate_binning(binning_z, file);
+
     m_values.setVariables(variables);
 
     bool formula = ptree.get<bool>("formula", false);
@@ -71,6 +80,33 @@ void BinnedValuesJSONParser::parse_file(const std::string& file) {
     else
         throw std::runtime_error("Invalid error_type. Only 'absolute', 'relative' and 'variated' are supported");
 
+    std::string interpolation = ptree.get<std::string>("interpolation", "none");
+    std::transform(interpolation.begin(), interpolation.end(), interpolation.begin(), ::tolower);
+
+    if (interpolation != "none" && interpolation != "linear")
+        throw std::runtime_error("Invalid interpolation. Only 'none' and 'linear' are supported");
+
+    if (ptree.count("components"))
+        m_values.components = get_string_array(ptree.get_child("components"));
+
+    if (! m_values.components.empty() && formula) {
+        std::string message{"Uncertainty components are only supported for binned values, not for formulas"};
+#ifdef STANDALONE_SCALEFACTORS
+        throw std::logic_error(message);
+#else
+        throw edm::Exception(edm::errors::LogicError, message);
+#endif
+    }
+
+    if (interpolation == "linear" && formula) {
+        std::string message{"Interpolation is only supported for binned values, not for formulas"};
+#ifdef STANDALONE_SCALEFACTORS
+        throw std::logic_error(message);
+#else
+        throw edm::Exception(edm::errors::LogicError, message);
+#endif
+    }
+
     switch (dimension) {
         case 1:
             if (!formula)
@@ -97,6 +133,31 @@ void BinnedValuesJSONParser::parse_file(const std::string& file) {
     if (formula) {
         parse_data<std::string>(ptree, dimension);
     } else {
+        // Bins missing from the file are left to NaN, and reported by validate()
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        for (std::size_t bin = 1; bin <= m_values.binned->size(); bin++) {
+            m_values.binned->setBinContent(bin, nan);
+            m_values.binned->setBinErrorLow(bin, nan);
+            m_values.binned->setBinErrorHigh(bin, nan);
+        }
+
+        if (! m_values.components.empty()) {
+            std::size_t size = 2 * m_values.components.size() * m_values.binned->size();
+            std::shared_ptr<float> storage(new float[size], std::default_delete<float[]>());
+            std::fill(storage.get(), storage.get() + size, nan);
+
+            m_component_errors = storage.get();
+            m_values.component_errors = storage.get();
+            m_values.component_storage = storage;
+        }
+
         parse_data<float>(ptree, dimension);
     }
+
+    m_values.validate(file);
+
+    if (!formula) {
+        if (interpolation == "linear")
+            m_values.interpolation.reset(new MultilinearInterpolation(*m_values.binned, m_values.component_errors, 2 * m_values.components.size()));
+    }
 }
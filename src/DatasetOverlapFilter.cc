@@ -0,0 +1,118 @@
+#include <cp3_llbb/Framework/interface/DatasetOverlapFilter.h>
+
+#include <FWCore/ParameterSet/interface/FileInPath.h>
+#include <FWCore/Utilities/interface/EDMException.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    HLTService::PathSet make_path_set(const std::vector<std::string>& patterns) {
+        HLTService::PathVector paths;
+        for (const auto& pattern: patterns)
+            paths.push_back(HLTService::PathName(pattern, boost::regex_constants::icase));
+
+        return HLTService::PathSet(paths);
+    }
+}
+
+DatasetOverlapFilter::DatasetOverlapFilter(const std::string& name, const edm::ParameterSet& config):
+    Filter(name, config) {
+
+    const std::string dataset = config.getUntrackedParameter<std::string>("dataset");
+    const std::vector<std::string> priorities = config.getUntrackedParameter<std::vector<std::string>>("priorities");
+    const edm::ParameterSet& triggers = config.getUntrackedParameter<edm::ParameterSet>("datasets");
+
+    auto position = std::find(priorities.begin(), priorities.end(), dataset);
+    if (position == priorities.end())
+        throw edm::Exception(edm::errors::Configuration, "Dataset '" + dataset + "' is not in the list of priorities of filter '" + name + "'");
+
+    for (auto it = priorities.begin(); it != priorities.end(); ++it) {
+        if (! triggers.existsAs<std::vector<std::string>>(*it, false))
+            throw edm::Exception(edm::errors::Configuration, "No paths given for dataset '" + *it + "' in filter '" + name + "'");
+
+        const std::vector<std::string> patterns = triggers.getUntrackedParameter<std::vector<std::string>>(*it);
+        if (it == position) {
+            if (patterns.empty())
+                throw edm::Exception(edm::errors::Configuration, "No paths given for dataset '" + *it + "' in filter '" + name + "'");
+
+            m_dataset_paths = make_path_set(patterns);
+            break;
+        }
+
+        m_veto_paths.push_back(make_path_set(patterns));
+    }
+
+    if (config.exists("triggers"))
+        m_hlt_service.reset(new HLTService(config.getUntrackedParameter<edm::FileInPath>("triggers").fullPath()));
+
+    std::cout << "    Keeping events of dataset '" << dataset << "' not in " << m_veto_paths.size() << " dataset(s) of higher priority" << std::endl;
+}
+
+const DatasetOverlapFilter::TriggerMenu& DatasetOverlapFilter::getTriggerMenu(const edm::TriggerNames& triggerNames, const HLTService::PathSet* valid_paths) {
+
+    auto key = std::make_pair(triggerNames.parameterSetID(), valid_paths);
+    if (m_current_menu && m_current_menu_key == key)
+        return *m_current_menu;
+
+    auto it = m_menus.find(key);
+    if (it == m_menus.end()) {
+        TriggerMenu menu;
+        for (size_t i = 0; i < triggerNames.size(); i++) {
+            const std::string& triggerName = triggerNames.triggerName(i);
+            if (valid_paths && ! valid_paths->matches(triggerName))
+                continue;
+
+            // Events firing a path of a dataset of higher priority are in this dataset too
+            if (std::any_of(m_veto_paths.begin(), m_veto_paths.end(), [&triggerName](const HLTService::PathSet& paths) { return paths.matches(triggerName); }))
+                menu.veto_indices.push_back(i);
+            else if (m_dataset_paths.matches(triggerName))
+                menu.dataset_indices.push_back(i);
+        }
+
+        if (menu.dataset_indices.empty())
+            std::cout << "Warning: filter '" << m_name << "': none of the paths of the dataset are in the trigger results, all events are rejected" << std::endl;
+
+        it = m_menus.emplace(key, std::move(menu)).first;
+    }
+
+    m_current_menu = &it->second;
+    m_current_menu_key = key;
+
+    return *m_current_menu;
+}
+
+bool DatasetOverlapFilter::filter(edm::Event& event, const edm::EventSetup& eventSetup) {
+
+    edm::Handle<edm::TriggerResults> hlt;
+    event.getByToken(m_hlt_token, hlt);
+
+    const HLTService::PathSet* valid_paths = nullptr;
+    if (m_hlt_service)
+        valid_paths = &m_hlt_service->getPaths(event.id().run());
+
+    const TriggerMenu& menu = getTriggerMenu(event.triggerNames(*hlt), valid_paths);
+
+    m_processed_events++;
+
+    for (size_t i: menu.veto_indices) {
+        if (hlt->accept(i)) {
+            m_duplicated_events++;
+            return false;
+        }
+    }
+
+    for (size_t i: menu.dataset_indices) {
+        if (hlt->accept(i))
+            return true;
+    }
+
+    m_untriggered_events++;
+    return false;
+}
+
+void DatasetOverlapFilter::endJob(MetadataManager& metadata) {
+    metadata.add(m_name + "_processed_events", double(m_processed_events));
+    metadata.add(m_name + "_duplicated_events", double(m_duplicated_events));
+    metadata.add(m_name + "_untriggered_events", double(m_untriggered_events));
+}
@@ -35,6 +35,7 @@ void ElectronsProducer::produce(edm::Event& event, const edm::EventSetup& eventS
         }
 
         fill_candidate(electron, electron.genParticle());
+        TriggerMatching::store_trigger_matches(event.id(), electron.eta(), electron.phi());
 
         reco::GsfElectron::PflowIsolationVariables pfIso = electron.pfIsolationVariables();
         computeIsolations_R03(pfIso.sumChargedHadronPt, pfIso.sumNeutralHadronEt, pfIso.sumPhotonEt, pfIso.sumPUPt, electron.pt(), electron.superCluster()->eta(), rho);
@@ -66,6 +67,7 @@ void ElectronsProducer::produce(edm::Event& event, const edm::EventSetup& eventS
         }
 
         Parameters p {{BinningVariable::Eta, electron.superCluster()->eta()}, {BinningVariable::Pt, electron.pt()}};
+        p.setRandomKey(random_key(event, electronRef.key()));
         ScaleFactors::store_scale_factors(p, event.isRealData());
     }
     Identifiable::clean();
@@ -0,0 +1,227 @@
+#include <cp3_llbb/Framework/interface/EventList.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    const char MAGIC[8] = {'C', 'P', '3', 'E', 'V', 'L', '\0', '\0'};
+
+    // 512 bits: one cache line
+    const size_t BLOOM_BLOCK_WORDS = 8;
+    const size_t BLOOM_BITS_PER_EVENT = 10;
+    const size_t BLOOM_HASHES = 6;
+
+    // Finalizer of splitmix64
+    uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    /**
+     * Block of the Bloom filter for an event, and the positions of its bits in the block,
+     * 9 bits per position
+     */
+    std::pair<size_t, uint64_t> bloom_probe(uint64_t hash, size_t n_blocks) {
+        uint64_t block_hash = mix(hash + 0x9e3779b97f4a7c15ULL);
+        return {((block_hash & 0xffffffff) * n_blocks >> 32) * BLOOM_BLOCK_WORDS, mix(block_hash)};
+    }
+
+    bool read_number(const char*& p, uint64_t max, uint64_t& value) {
+        while (*p == ' ' || *p == '\t' || *p == ':' || *p == ',')
+            p++;
+
+        if (*p < '0' || *p > '9')
+            return false;
+
+        errno = 0;
+        char* end;
+        unsigned long long result = std::strtoull(p, &end, 10);
+        if (errno == ERANGE || result > max)
+            return false;
+
+        value = result;
+        p = end;
+        return true;
+    }
+}
+
+uint64_t EventList::hash(uint32_t run, uint32_t lumi, uint64_t event) {
+    return mix(mix((uint64_t(run) << 32) | lumi) ^ event);
+}
+
+EventList::EventList(const std::string& file, bool bloom_filter) {
+
+    char magic[sizeof(MAGIC)] = {0};
+    {
+        std::ifstream stream(file, std::ios::binary);
+        if (! stream)
+            throw std::runtime_error("Failed to open " + file + ": " + std::strerror(errno));
+
+        stream.read(magic, sizeof(magic));
+    }
+
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0)
+        parse_binary(file);
+    else
+        parse_text(file);
+
+    build(bloom_filter);
+}
+
+EventList::EventList(std::vector<Entry> entries, bool bloom_filter):
+    m_entries(std::move(entries)) {
+    build(bloom_filter);
+}
+
+void EventList::parse_text(const std::string& file) {
+
+    std::ifstream stream(file);
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(stream, line)) {
+        line_number++;
+
+        const char* p = line.c_str();
+        while (*p == ' ' || *p == '\t')
+            p++;
+
+        if (*p == '\0' || *p == '\r' || *p == '#')
+            continue;
+
+        uint64_t run, lumi, event;
+        bool valid = read_number(p, std::numeric_limits<uint32_t>::max(), run) &&
+            read_number(p, std::numeric_limits<uint32_t>::max(), lumi) &&
+            read_number(p, std::numeric_limits<uint64_t>::max(), event);
+
+        while (valid && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+
+        if (! valid || *p != '\0')
+            throw std::logic_error("Invalid event at line " + std::to_string(line_number) + " of " + file + ": '" + line + "'");
+
+        m_entries.push_back({uint32_t(run), uint32_t(lumi), event});
+    }
+
+    if (stream.bad())
+        throw std::runtime_error("Failed to read " + file);
+}
+
+void EventList::parse_binary(const std::string& file) {
+
+    std::ifstream stream(file, std::ios::binary);
+
+    Header header;
+    if (! stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("Unexpected end of file while reading " + file);
+
+    if (header.version != VERSION)
+        throw std::runtime_error("Unsupported version of the event list format in " + file + ": " + std::to_string(header.version) + " (expected " + std::to_string(VERSION) + ")");
+
+    // Check the number of events against the size of the file before allocating anything: a
+    // corrupted header could otherwise request an arbitrarily large allocation
+    std::streampos start = stream.tellg();
+    stream.seekg(0, std::ios::end);
+    std::streamoff remaining = stream.tellg() - start;
+    stream.seekg(start);
+
+    if (remaining < 0 || remaining % sizeof(Entry) != 0 || header.n_events != uint64_t(remaining) / sizeof(Entry))
+        throw std::runtime_error("Unexpected end of file while reading " + file);
+
+    m_entries.resize(header.n_events);
+    if (! stream.read(reinterpret_cast<char*>(m_entries.data()), header.n_events * sizeof(Entry)))
+        throw std::runtime_error("Unexpected end of file while reading " + file);
+}
+
+void EventList::build(bool bloom_filter) {
+
+    std::sort(m_entries.begin(), m_entries.end());
+    m_entries.erase(std::unique(m_entries.begin(), m_entries.end()), m_entries.end());
+
+    if (m_entries.size() >= std::numeric_limits<uint32_t>::max())
+        throw std::logic_error("Too many events in the event list: " + std::to_string(m_entries.size()));
+
+    // About one entry per bucket
+    m_bucket_bits = 0;
+    while ((size_t(1) << m_bucket_bits) < m_entries.size())
+        m_bucket_bits++;
+
+    size_t n_buckets = size_t(1) << m_bucket_bits;
+
+    // Counting sort of the entries by bucket
+    std::vector<uint32_t> buckets(m_entries.size());
+    m_buckets.assign(n_buckets + 1, 0);
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        const Entry& entry = m_entries[i];
+        buckets[i] = bucket(hash(entry.run, entry.lumi, entry.event));
+        m_buckets[buckets[i] + 1]++;
+    }
+
+    for (size_t i = 0; i < n_buckets; i++)
+        m_buckets[i + 1] += m_buckets[i];
+
+    std::vector<Entry> entries(m_entries.size());
+    std::vector<uint32_t> positions(m_buckets.begin(), m_buckets.end() - 1);
+    for (size_t i = 0; i < m_entries.size(); i++)
+        entries[positions[buckets[i]]++] = m_entries[i];
+
+    m_entries = std::move(entries);
+
+    m_bloom.clear();
+    m_bloom_blocks = 0;
+    if (! bloom_filter)
+        return;
+
+    m_bloom_blocks = std::max<size_t>(1, (m_entries.size() * BLOOM_BITS_PER_EVENT + 64 * BLOOM_BLOCK_WORDS - 1) / (64 * BLOOM_BLOCK_WORDS));
+    m_bloom.assign(m_bloom_blocks * BLOOM_BLOCK_WORDS, 0);
+
+    for (const Entry& entry: m_entries) {
+        auto probe = bloom_probe(hash(entry.run, entry.lumi, entry.event), m_bloom_blocks);
+        uint64_t* block = &m_bloom[probe.first];
+
+        uint64_t bits = probe.second;
+        for (size_t i = 0; i < BLOOM_HASHES; i++, bits >>= 9)
+            block[(bits & 511) / 64] |= uint64_t(1) << (bits & 63);
+    }
+}
+
+bool EventList::may_contain(uint64_t hash) const {
+    auto probe = bloom_probe(hash, m_bloom_blocks);
+    const uint64_t* block = &m_bloom[probe.first];
+
+    uint64_t bits = probe.second;
+    for (size_t i = 0; i < BLOOM_HASHES; i++, bits >>= 9) {
+        if (! (block[(bits & 511) / 64] & (uint64_t(1) << (bits & 63))))
+            return false;
+    }
+
+    return true;
+}
+
+bool EventList::contains(uint32_t run, uint32_t lumi, uint64_t event) const {
+
+    if (m_entries.empty())
+        return false;
+
+    uint64_t h = hash(run, lumi, event);
+    if (! m_bloom.empty() && ! may_contain(h))
+        return false;
+
+    size_t b = bucket(h);
+    Entry key {run, lumi, event};
+    for (uint32_t i = m_buckets[b]; i < m_buckets[b + 1]; i++) {
+        if (m_entries[i] == key)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,40 @@
+#include <cp3_llbb/Framework/interface/EventListFilter.h>
+
+#include <FWCore/Utilities/interface/EDMException.h>
+
+#include <iostream>
+
+EventListFilter::EventListFilter(const std::string& name, const edm::ParameterSet& config):
+    Filter(name, config) {
+
+    const std::string mode = config.getUntrackedParameter<std::string>("mode", "veto");
+    if (mode != "veto" && mode != "keep")
+        throw edm::Exception(edm::errors::Configuration, "Invalid mode '" + mode + "' for filter '" + name + "'. Valid modes are 'veto' and 'keep'");
+    m_keep = (mode == "keep");
+
+    const std::string file = config.getUntrackedParameter<std::string>("file");
+    try {
+        m_events.reset(new EventList(file, config.getUntrackedParameter<bool>("bloom_filter", false)));
+    } catch (const std::exception& e) {
+        throw edm::Exception(edm::errors::Configuration, "Failed to load the event list '" + file + "': " + e.what());
+    }
+
+    std::cout << "    Event list '" << file << "': " << m_events->size() << " events, " << (m_keep ? "keeping only them" : "rejecting them") << std::endl;
+}
+
+bool EventListFilter::filter(edm::Event& event, const edm::EventSetup& eventSetup) {
+    const edm::EventID& id = event.id();
+
+    m_processed_events++;
+
+    bool pass = m_events->contains(id.run(), id.luminosityBlock(), id.event()) == m_keep;
+    if (! pass)
+        m_rejected_events++;
+
+    return pass;
+}
+
+void EventListFilter::endJob(MetadataManager& metadata) {
+    metadata.add(m_name + "_processed_events", double(m_processed_events));
+    metadata.add(m_name + "_rejected_events", double(m_rejected_events));
+}
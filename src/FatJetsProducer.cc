@@ -7,7 +7,8 @@ void FatJetsProducer::produce(edm::Event& event, const edm::EventSetup& eventSet
     edm::Handle<std::vector<pat::Jet>> jets;
     event.getByToken(m_jets_token, jets);
 
-    for (const auto& jet: *jets) {
+    for (size_t index = 0; index < jets->size(); index++) {
+        const pat::Jet& jet = (*jets)[index];
         if (! pass_cut(jet))
             continue;
 
@@ -77,23 +78,25 @@ void FatJetsProducer::produce(edm::Event& event, const edm::EventSetup& eventSet
             m_softdrop_puppi_btag_discriminators_branches[subjet_btag]->push_back(subjets_btag_discriminators[subjet_btag]);
         }
 
-        for (auto& it: m_btag_discriminators) {
+        Parameters p {{BinningVariable::Eta, jet.eta()}, {BinningVariable::Pt, jet.pt()}};
+        p.setRandomKey(random_key(event, index));
+        for (auto& btag: m_btags) {
 
-            float btag_discriminator = jet.bDiscriminator(it.first);
+            float btag_discriminator = jet.bDiscriminator(btag.name);
             // Protect against NaN discriminant
             if (std::isnan(btag_discriminator))
                 btag_discriminator = -10;
 
-            it.second->push_back(btag_discriminator);
+            btag.branch->push_back(btag_discriminator);
 
-            Parameters p {{BinningVariable::Eta, jet.eta()}, {BinningVariable::Pt, jet.pt()}, {BinningVariable::BTagDiscri, btag_discriminator}};
-
-            Algorithm algo = string_to_algorithm(it.first);
-            if (algo != Algorithm::UNKNOWN && BTaggingScaleFactors::has_scale_factors(algo)) {
-                BTaggingScaleFactors::store_scale_factors(algo, jet_flavor, p, event.isRealData());
+            if (btag.algo != Algorithm::UNKNOWN) {
+                p.setBTagDiscri(btag_discriminator);
+                BTaggingScaleFactors::store_scale_factors(btag.algo, jet_flavor, p, event.isRealData());
             }
         }
     }
+
+    BTaggingScaleFactors::store_event_weights();
 }
 
 float FatJetsProducer::get_scale_factor(Algorithm algo, const std::string& wp, size_t index, Variation variation/* = Variation::Nominal*/) {
@@ -1,6 +1,11 @@
 #include <FWCore/PluginManager/interface/PluginFactory.h>
 
 #include <cp3_llbb/Framework/interface/METFilter.h>
+#include <cp3_llbb/Framework/interface/LumiMaskFilter.h>
+#include <cp3_llbb/Framework/interface/DatasetOverlapFilter.h>
+#include <cp3_llbb/Framework/interface/EventListFilter.h>
 
 DEFINE_EDM_PLUGIN(ExTreeMakerFilterFactory, METFilter, "met");
-
+DEFINE_EDM_PLUGIN(ExTreeMakerFilterFactory, LumiMaskFilter, "lumi_mask");
+DEFINE_EDM_PLUGIN(ExTreeMakerFilterFactory, DatasetOverlapFilter, "dataset_overlap");
+DEFINE_EDM_PLUGIN(ExTreeMakerFilterFactory, EventListFilter, "event_list");
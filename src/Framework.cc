@@ -22,6 +22,7 @@
 
 // user include files
 #include <cp3_llbb/Framework/interface/Framework.h>
+#include <cp3_llbb/Framework/interface/ScaleFactorsRegistry.h>
 #include <cp3_llbb/Framework/interface/Tools.h>
 #include <cp3_llbb/TreeWrapper/interface/TreeWrapper.h>
 
@@ -148,6 +149,8 @@ ExTreeMaker::ExTreeMaker(const edm::ParameterSet& iConfig)
             m_producers.push_back(std::make_pair(producerName, producer));
         }
 
+        ScaleFactorsRegistry::get().print_summary();
+
         if (!iConfig.existsAs<edm::ParameterSet>("analyzers")) {
             return;
         }
@@ -237,6 +240,10 @@ void ExTreeMaker::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
     if (! should_continue) {
         m_wrapper->reset();
         m_categories->reset();
+
+        for (auto& producer: m_producers)
+            producer.second->endEvent();
+
         return;
     }
 
@@ -256,6 +263,9 @@ void ExTreeMaker::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
         gDebug = 1;
 #endif
 
+        for (auto& producer: m_producers)
+            producer.second->beforeFill();
+
         size_t zipSize = m_raw_tree->GetZipBytes();
         m_wrapper->fillBranches();
         m_filled_size += (m_raw_tree->GetZipBytes() - zipSize);
@@ -288,8 +298,10 @@ void ExTreeMaker::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
     for (auto& analyzer: m_analyzers)
         analyzer.analyzer->setRun(false);
 
-    for (auto& producer: m_producers)
+    for (auto& producer: m_producers) {
+        producer.second->endEvent();
         producer.second->setRun(false);
+    }
 
 #ifdef DEBUG_MEMORY_USAGE
     std::cout << "[Framework - <<produce] RSS: " << Tools::process_mem_usage() << std::endl;
@@ -1,91 +1,190 @@
 
 #include <cp3_llbb/Framework/interface/HLTProducer.h>
 
-void HLTProducer::produce(edm::Event& event, const edm::EventSetup& eventSetup) {
+#include <FWCore/ServiceRegistry/interface/Service.h>
+#include <CommonTools/UtilAlgos/interface/TFileService.h>
 
-    edm::Handle<edm::TriggerResults> hlt;
-    event.getByToken(m_hlt_token, hlt);
+#include <TTree.h>
+
+const uint16_t HLTProducer::NOT_ACCEPTED;
+
+void HLTProducer::createLumiTree() {
+    edm::Service<TFileService> fs;
+    m_lumi_tree = fs->make<TTree>((m_name + "_lumis").c_str(), (m_name + "_lumis").c_str());
+    m_lumi_wrapper.reset(new ROOT::TreeWrapper(m_lumi_tree));
+
+    // Entry of the lumi tree with the prescales of the event
+    m_lumi_index = &tree["lumi_index"].write<uint32_t>();
+}
+
+const HLTProducer::TriggerMenu& HLTProducer::getTriggerMenu(const edm::TriggerNames& triggerNames, const HLTService::PathSet* valid_paths) {
+
+    auto key = std::make_pair(triggerNames.parameterSetID(), valid_paths);
+    if (m_current_menu && m_current_menu_key == key)
+        return *m_current_menu;
+
+    auto it = m_menus.find(key);
+    if (it == m_menus.end()) {
+        TriggerMenu menu;
+        menu.names = triggerNames.triggerNames();
+        menu.selected.resize(menu.names.size(), false);
+
+        for (size_t i = 0; i < menu.names.size(); i++) {
+            const std::string& triggerName = menu.names[i];
+            if (triggerName == "HLTriggerFinalPath")
+                continue; // This one is pretty useless...
+            if (triggerName[0] == 'A')
+                continue; // Remove AlCa HLT paths
+
+            if (! valid_paths || valid_paths->matches(triggerName)) {
+                menu.selected[i] = true;
+                menu.sorted_indices.push_back(i);
+                menu.indices[triggerName] = i;
+            }
+        }
+
+        std::sort(menu.sorted_indices.begin(), menu.sorted_indices.end(), [&menu](size_t a, size_t b) {
+                return menu.names[a] < menu.names[b];
+            });
+
+        it = m_menus.emplace(key, std::move(menu)).first;
+    }
+
+    m_current_menu = &it->second;
+    m_current_menu_key = key;
+
+    return *m_current_menu;
+}
+
+void HLTProducer::updatePrescales(const edm::Event& event, const TriggerMenu& menu) {
 
     edm::Handle<pat::PackedTriggerPrescales> prescales_;
     event.getByToken(m_prescales_token, prescales_);
 
+    m_prescales_menu = &menu;
+    m_has_prescales = prescales_.isValid();
+    m_menu_prescales.assign(menu.names.size(), 0);
+
+    if (m_has_prescales) {
+        for (size_t i: menu.sorted_indices)
+            m_menu_prescales[i] = prescales_->getPrescaleForIndex(i);
+    }
+
+    if (! m_lumi_tree)
+        return;
+
+    (*m_lumi_wrapper)["run"].write<uint32_t>() = event.id().run();
+    (*m_lumi_wrapper)["lumi"].write<uint32_t>() = event.id().luminosityBlock();
+
+    auto& lumi_paths = (*m_lumi_wrapper)["paths"].write<std::vector<std::string>>();
+    auto& lumi_prescales = (*m_lumi_wrapper)["prescales"].write<std::vector<uint16_t>>();
+    for (size_t i: menu.sorted_indices) {
+        lumi_paths.push_back(menu.names[i]);
+        if (m_has_prescales)
+            lumi_prescales.push_back(m_menu_prescales[i]);
+    }
+
+    m_lumi_wrapper->fillBranches();
+    m_lumi_entries++;
+}
+
+void HLTProducer::produce(edm::Event& event, const edm::EventSetup& eventSetup) {
+
+    edm::Handle<edm::TriggerResults> hlt;
+    event.getByToken(m_hlt_token, hlt);
+
     const edm::TriggerNames& triggerNames = event.triggerNames(*hlt);
 
     bool filter = m_hlt_service.get() != nullptr;
-    const HLTService::PathVector* valid_paths = nullptr;
+    const HLTService::PathSet* valid_paths = nullptr;
     if (filter) {
         valid_paths = &m_hlt_service->getPaths(event.id().run());
     }
 
-    for (size_t i = 0 ; i < hlt->size(); i++) {
-        if (hlt->accept(i)) {
-            std::string triggerName = triggerNames.triggerName(i);
-            if (triggerName == "HLTriggerFinalPath")
-                continue; // This one is pretty useless...
-            if (triggerName[0] == 'A')
-                continue; // Remove AlCa HLT paths
+    const TriggerMenu& menu = getTriggerMenu(triggerNames, valid_paths);
 
-            bool add = false;
-            if (filter) {
-                for (const auto& regex: *valid_paths) {
-                    if (boost::regex_match(triggerName, regex)) {
-                        add = true;
-                        break;
-                    }
-                }
-            } else {
-                add = true;
-            }
+    if (m_prescales_menu != &menu)
+        updatePrescales(event, menu);
 
-            if (add) {
-                paths.push_back(triggerName);
-                if (prescales_.isValid()) {
-                    prescales.push_back(prescales_->getPrescaleForIndex(i));
-                }
-            }
-        }
+    if (m_lumi_index)
+        *m_lumi_index = m_lumi_entries - 1;
+
+    TriggerObjectsIndex& objects_index = TriggerObjectsIndex::get();
+    objects_index.reset(event.id(), &menu.names);
+
+    // Forget the paths of the previous event
+    for (size_t i: m_accepted_indices)
+        m_path_positions[i] = NOT_ACCEPTED;
+    m_accepted_indices.clear();
+    m_path_positions.resize(menu.names.size(), NOT_ACCEPTED);
+
+    // Paths are visited sorted by name, so prescales stay aligned with the sorted paths
+    for (size_t i: menu.sorted_indices) {
+        if (! hlt->accept(i))
+            continue;
+
+        m_path_positions[i] = paths.size();
+        m_accepted_indices.push_back(i);
+
+        paths.push_back(menu.names[i]);
+        if (m_has_prescales && ! m_lumi_tree)
+            prescales.push_back(m_menu_prescales[i]);
     }
 
     if (paths.empty())
         return;
 
-    std::sort(paths.begin(), paths.end());
-
     edm::Handle<pat::TriggerObjectStandAloneCollection> objects;
     event.getByToken(m_trigger_objects_token, objects);
 
     if (objects.isValid()) {
-    
+
+        std::vector<uint16_t> positions;
+        std::vector<size_t> trigger_indices;
         for (pat::TriggerObjectStandAlone obj : *objects) {
+            // Path names are only available by name once unpacked: turn them into positions in
+            // the paths branch, keeping only the accepted paths we are interested in
             obj.unpackPathNames(triggerNames);
 
-            std::vector<std::string> object_paths_ = obj.pathNames(false);
+            positions.clear();
+            for (const auto& path: obj.pathNames(false)) {
+                auto index = menu.indices.find(path);
+                if (index == menu.indices.end())
+                    continue;
 
-            // Check if this object has triggered at least one of the path we are interesting in
-            bool keep = false;
-            if (filter) {
-                for (const auto& path: object_paths_) {
-                    if (std::find(paths.begin(), paths.end(), path) != paths.end()) {
-                        keep = true;
-                        break;
-                    }
-                }
-            } else {
-                keep = true;
+                uint16_t position = m_path_positions[index->second];
+                if (position != NOT_ACCEPTED)
+                    positions.push_back(position);
             }
 
-            if (! keep)
+            // Check if this object has triggered at least one of the path we are interesting in
+            if (filter && positions.empty())
                 continue;
 
-            std::sort(object_paths_.begin(), object_paths_.end());
+            // Paths are sorted by name, so are the object paths
+            std::sort(positions.begin(), positions.end());
 
             std::vector<std::string> filtered_paths;
-            std::set_intersection(paths.begin(), paths.end(), object_paths_.begin(), object_paths_.end(), std::back_inserter(filtered_paths));
+            filtered_paths.reserve(positions.size());
+            trigger_indices.clear();
+            for (uint16_t position: positions) {
+                filtered_paths.push_back(paths[position]);
+                trigger_indices.push_back(m_accepted_indices[position]);
+            }
 
-            object_paths.push_back(filtered_paths);
+            objects_index.add_object(obj.eta(), obj.phi(), obj.pdgId(), trigger_indices, obj.filterLabels());
+
+            object_paths.push_back(std::move(filtered_paths));
+            object_path_indices.push_back(positions);
             object_filters.push_back(obj.filterLabels());
             object_p4.push_back(LorentzVector(obj.pt(), obj.eta(), obj.phi(), obj.energy()));
             object_pdg_id.push_back(obj.pdgId());
         }
     }
 }
+
+void HLTProducer::endJob(MetadataManager& metadata) {
+    // Branches of the lumi tree are filled separately
+    if (m_lumi_tree)
+        m_lumi_tree->SetEntries(-1);
+}
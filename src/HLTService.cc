@@ -1,10 +1,51 @@
 #include <cp3_llbb/Framework/interface/HLTService.h>
 #include "tinyxml2.h"
 
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
 using namespace tinyxml2;
 
+const size_t HLTService::PathSet::NO_MATCH;
+
+HLTService::PathSet::PathSet(const PathVector& patterns):
+    m_patterns(patterns) {
+
+    if (m_patterns.empty())
+        return;
+
+    std::string combined;
+    size_t group = 1;
+    for (const auto& pattern: m_patterns) {
+        if (! combined.empty())
+            combined += "|";
+        combined += "(" + pattern.str() + ")";
+
+        m_groups.push_back(group);
+        group += 1 + pattern.mark_count();
+    }
+
+    m_combined = PathName(combined, boost::regex_constants::icase);
+}
+
+size_t HLTService::PathSet::match(const std::string& name) const {
+    if (m_patterns.empty())
+        return NO_MATCH;
+
+    boost::smatch result;
+    if (! boost::regex_match(name, result, m_combined))
+        return NO_MATCH;
+
+    for (size_t i = 0; i < m_groups.size(); i++) {
+        if (result[m_groups[i]].matched)
+            return i;
+    }
+
+    return NO_MATCH;
+}
+
 bool HLTService::parse(const std::string& filename) {
     XMLDocument doc;
     if (doc.LoadFile(filename.c_str())) {
@@ -35,24 +76,63 @@ bool HLTService::parseRunsElement(const XMLElement* runs) {
         runPaths.push_back(PathName(name, boost::regex_constants::icase));
     }
 
-    m_paths[runRange] = runPaths;
+    m_paths[runRange] = PathSet(runPaths);
     return true;
 }
 
-const HLTService::PathVector& HLTService::getPaths(uint64_t run) {
+void HLTService::buildIndex() {
+    // Split the runs at each range boundary, so that each interval is either fully inside a range or fully outside
+    std::vector<uint64_t> boundaries;
+    for (const auto& path: m_paths) {
+        boundaries.push_back(path.first.from());
+        boundaries.push_back(path.first.to() + 1);
+    }
+
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    for (size_t i = 0; i + 1 < boundaries.size(); i++) {
+        uint64_t from = boundaries[i];
+        uint64_t to = boundaries[i + 1] - 1;
+
+        // Ranges are sorted by first run: keep the first one containing the interval
+        const PathSet* paths = nullptr;
+        for (const auto& path: m_paths) {
+            if (path.first.in(from)) {
+                paths = &path.second;
+                break;
+            }
+        }
+
+        if (! paths)
+            continue;
+
+        // Merge with the previous interval if it has the same paths
+        if (! m_index.empty() && m_index.back().paths == paths && m_index.back().runs.to() + 1 == from)
+            m_index.back().runs = Range<uint64_t>(m_index.back().runs.from(), to);
+        else
+            m_index.push_back({Range<uint64_t>(from, to), paths});
+    }
+}
+
+const HLTService::PathSet& HLTService::getPaths(uint64_t run) {
     if (m_cachedRange && m_cachedRange->in(run)) {
-        return *m_cachedVector;
+        return *m_cachedPaths;
     }
 
-    for (auto& path: m_paths) {
-        const auto& runRange = path.first;
+    // Last interval starting before or at this run
+    auto interval = std::upper_bound(m_index.begin(), m_index.end(), run, [](uint64_t run, const Interval& interval) {
+            return run < interval.runs.from();
+        });
 
-        if (runRange.in(run)) {
+    if (interval != m_index.begin()) {
+        --interval;
+        if (interval->runs.in(run)) {
 
-            m_cachedRange = &runRange;
-            m_cachedVector = &path.second;
+            m_cachedRange = &interval->runs;
+            m_cachedPaths = interval->paths;
 
-            return *m_cachedVector;
+            return *m_cachedPaths;
         }
     }
 
@@ -67,7 +147,7 @@ void HLTService::print() {
         const auto& paths = p.second;
 
         std::cout << " -> Runs: " << runRange << std::endl;
-        for (auto& path: paths) {
+        for (auto& path: paths.patterns()) {
             std::cout << "    - " << path << std::endl;
         }
     }
@@ -0,0 +1,84 @@
+#include <cp3_llbb/Framework/interface/LumiMask.h>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+
+LumiMask::LumiMask(const std::string& filename) {
+    parse(filename);
+}
+
+void LumiMask::parse(const std::string& filename) {
+
+    boost::property_tree::ptree ptree;
+    boost::property_tree::read_json(filename, ptree);
+
+    // Runs may be listed in any order, and intervals may overlap
+    std::map<uint64_t, std::vector<Range<uint64_t>>> runs;
+    for (const auto& run: ptree) {
+        uint64_t run_number;
+        try {
+            size_t end;
+            run_number = std::stoull(run.first, &end);
+            if (end != run.first.size())
+                throw std::invalid_argument(run.first);
+        } catch (const std::logic_error&) {
+            throw std::logic_error("Invalid run number in '" + filename + "': '" + run.first + "'");
+        }
+
+        auto& lumis = runs[run_number];
+        for (const auto& interval: run.second) {
+            std::vector<uint64_t> bounds;
+            for (const auto& bound: interval.second)
+                bounds.push_back(bound.second.get_value<uint64_t>());
+
+            if (bounds.size() != 2 || bounds[0] > bounds[1])
+                throw std::logic_error("Invalid luminosity block interval for run " + std::to_string(run_number) + " in '" + filename + "'");
+
+            lumis.emplace_back(bounds[0], bounds[1]);
+        }
+    }
+
+    for (auto& run: runs) {
+        auto& lumis = run.second;
+        std::sort(lumis.begin(), lumis.end());
+
+        m_runs.push_back(run.first);
+        m_offsets.push_back(m_lumis.size());
+
+        // Merge overlapping and adjacent intervals
+        size_t first = m_lumis.size();
+        for (const auto& lumi: lumis) {
+            if (m_lumis.size() > first && lumi.from() <= m_lumis.back().to() + 1)
+                m_lumis.back() = Range<uint64_t>(m_lumis.back().from(), std::max(m_lumis.back().to(), lumi.to()));
+            else
+                m_lumis.push_back(lumi);
+        }
+    }
+
+    m_offsets.push_back(m_lumis.size());
+}
+
+bool LumiMask::contains(uint64_t run, uint64_t lumi) const {
+
+    auto run_it = std::lower_bound(m_runs.begin(), m_runs.end(), run);
+    if (run_it == m_runs.end() || *run_it != run)
+        return false;
+
+    size_t index = run_it - m_runs.begin();
+    auto first = m_lumis.begin() + m_offsets[index];
+    auto last = m_lumis.begin() + m_offsets[index + 1];
+
+    // Last interval starting before or at lumi
+    auto it = std::upper_bound(first, last, lumi, [](uint64_t value, const Range<uint64_t>& range) {
+            return value < range.from();
+        });
+
+    if (it == first)
+        return false;
+
+    return std::prev(it)->in(lumi);
+}
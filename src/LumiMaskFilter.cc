@@ -0,0 +1,31 @@
+#include <cp3_llbb/Framework/interface/LumiMaskFilter.h>
+
+#include <FWCore/Utilities/interface/EDMException.h>
+
+#include <iostream>
+
+LumiMaskFilter::LumiMaskFilter(const std::string& name, const edm::ParameterSet& config):
+    Filter(name, config) {
+
+    const std::string json = config.getUntrackedParameter<std::string>("json");
+    try {
+        m_mask = LumiMask(json);
+    } catch (const std::exception& e) {
+        throw edm::Exception(edm::errors::Configuration, "Failed to load the luminosity mask '" + json + "': " + e.what());
+    }
+
+    std::cout << "    Luminosity mask '" << json << "': " << m_mask.runs() << " runs, " << m_mask.intervals() << " luminosity block intervals" << std::endl;
+}
+
+void LumiMaskFilter::beginLuminosityBlock(const edm::LuminosityBlock& lumi, const edm::EventSetup& eventSetup) {
+    m_certified = m_mask.contains(lumi.id().run(), lumi.id().luminosityBlock());
+
+    m_processed_lumis++;
+    if (! m_certified)
+        m_rejected_lumis++;
+}
+
+void LumiMaskFilter::endJob(MetadataManager& metadata) {
+    metadata.add(m_name + "_processed_lumis", double(m_processed_lumis));
+    metadata.add(m_name + "_rejected_lumis", double(m_rejected_lumis));
+}
@@ -1,22 +1,80 @@
 #include <cp3_llbb/Framework/interface/METFilter.h>
 
-#include <FWCore/Common/interface/TriggerNames.h>
+#include <FWCore/Utilities/interface/EDMException.h>
+
+#include <iostream>
+
+const size_t METFilter::NOT_FOUND;
+
+const std::vector<size_t>& METFilter::getFlagIndices(const edm::TriggerNames& triggerNames) {
+
+    if (m_current_indices && m_current_menu == triggerNames.parameterSetID())
+        return *m_current_indices;
+
+    auto it = m_menus.find(triggerNames.parameterSetID());
+    if (it == m_menus.end()) {
+        std::vector<size_t> indices(m_flags.size(), NOT_FOUND);
+        std::vector<std::string> missing_flags;
+
+        for (size_t flag = 0; flag < m_flags.size(); flag++) {
+            size_t index = triggerNames.triggerIndex(m_flags[flag]);
+            if (index < triggerNames.size())
+                indices[flag] = index;
+            else
+                missing_flags.push_back(m_flags[flag]);
+        }
+
+        if (! missing_flags.empty()) {
+            std::string list;
+            for (const auto& flag: missing_flags)
+                list += (list.empty() ? "" : ", ") + flag;
+
+            if (! m_allow_missing_flags)
+                throw edm::Exception(edm::errors::Configuration, "MET filter '" + m_name + "': flags not found in the trigger results: " + list + ". Remove them from the 'flags' parameter, or set 'allow_missing_flags' to ignore them.");
+
+            std::cout << "Warning: MET filter '" << m_name << "': flags not found in the trigger results, they are ignored: " << list << std::endl;
+        }
+
+        it = m_menus.emplace(triggerNames.parameterSetID(), std::move(indices)).first;
+    }
+
+    m_current_indices = &it->second;
+    m_current_menu = triggerNames.parameterSetID();
+
+    return *m_current_indices;
+}
 
 bool METFilter::filter(edm::Event& event, const edm::EventSetup& eventSetup) {
     edm::Handle<edm::TriggerResults> filters;
     event.getByToken(m_met_filters_token, filters);
 
     const edm::TriggerNames& triggerNames = event.triggerNames(*filters);
+    const std::vector<size_t>& indices = getFlagIndices(triggerNames);
+
+    m_processed_events++;
 
-    for (size_t i = 0 ; i < filters->size(); i++) {
-        std::string triggerName = triggerNames.triggerName(i);
-        if (std::find(m_flags.begin(), m_flags.end(), triggerName) != m_flags.end()) {
-            if (!filters->accept(i))
-                return false;
-        } else {
+    // All the flags are evaluated, so that each rejection count is independent of the order of the flags
+    bool pass = true;
+    for (size_t flag = 0; flag < indices.size(); flag++) {
+        if (indices[flag] == NOT_FOUND)
             continue;
+
+        if (! filters->accept(indices[flag])) {
+            m_rejections[flag]++;
+            pass = false;
         }
     }
 
-    return true;
+    if (! pass)
+        m_rejected_events++;
+
+    return pass;
+}
+
+void METFilter::endJob(MetadataManager& metadata) {
+    metadata.add(m_name + "_processed_events", double(m_processed_events));
+    metadata.add(m_name + "_rejected_events", double(m_rejected_events));
+
+    for (size_t flag = 0; flag < m_flags.size(); flag++)
+        metadata.add(m_name + "_rejected_events_" + m_flags[flag], double(m_rejections[flag]));
 }
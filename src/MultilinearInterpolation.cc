@@ -0,0 +1,122 @@
+#include <cp3_llbb/Framework/interface/MultilinearInterpolation.h>
+
+#include <algorithm>
+#include <cmath>
+
+MultilinearInterpolation::MultilinearInterpolation(Histogram<float>& h, const float* extra_errors/* = nullptr*/, std::size_t n_extra_errors/* = 0*/) {
+    std::vector<std::vector<float>> binning = h.getBinning();
+
+    m_dimension = binning.size();
+    m_n_corners = std::size_t(1) << m_dimension;
+    m_n_quantities = 3 + n_extra_errors;
+
+    // Number of bins along each axis, used to compute the histogram bin index
+    std::vector<std::size_t> n_bins;
+
+    std::size_t n_cells = 1;
+    for (const auto& edges: binning) {
+        Axis axis;
+        for (std::size_t i = 0; i < edges.size() - 1; i++)
+            axis.centres.push_back((edges[i] + edges[i + 1]) / 2.);
+
+        for (std::size_t i = 0; i + 1 < axis.centres.size(); i++)
+            axis.inverse_widths.push_back(1. / (axis.centres[i + 1] - axis.centres[i]));
+
+        axis.n_cells = std::max<std::size_t>(axis.centres.size() - 1, 1);
+
+        n_bins.push_back(axis.centres.size());
+        n_cells *= axis.n_cells;
+        m_axes.push_back(axis);
+    }
+
+    m_coefficients.resize(n_cells * m_n_quantities * m_n_corners);
+
+    std::vector<std::size_t> cell_index(m_dimension, 0);
+    for (std::size_t cell = 0; cell < n_cells; cell++) {
+        float* coefficients = &m_coefficients[cell * m_n_quantities * m_n_corners];
+
+        // Start from the values at the corners of the cell
+        for (std::size_t corner = 0; corner < m_n_corners; corner++) {
+            std::size_t bin = 0;
+            std::size_t stride = 1;
+            for (std::size_t d = 0; d < m_dimension; d++) {
+                std::size_t index = cell_index[d] + ((corner >> d) & 1);
+                index = std::min(index, n_bins[d] - 1);
+
+                bin += index * stride;
+                stride *= n_bins[d];
+            }
+
+            coefficients[corner] = h.getBinContent(bin + 1);
+            coefficients[m_n_corners + corner] = h.getBinErrorLow(bin + 1);
+            coefficients[2 * m_n_corners + corner] = h.getBinErrorHigh(bin + 1);
+
+            for (std::size_t q = 0; q < n_extra_errors; q++)
+                coefficients[(3 + q) * m_n_corners + corner] = extra_errors[bin * n_extra_errors + q];
+        }
+
+        // Turn them into the coefficients of the multilinear polynomial, one axis at a time
+        for (std::size_t q = 0; q < m_n_quantities; q++) {
+            float* c = coefficients + q * m_n_corners;
+            for (std::size_t d = 0; d < m_dimension; d++) {
+                for (std::size_t corner = 0; corner < m_n_corners; corner++) {
+                    if (corner & (std::size_t(1) << d))
+                        c[corner] -= c[corner ^ (std::size_t(1) << d)];
+                }
+            }
+        }
+
+        // Next cell, x running fastest
+        for (std::size_t d = 0; d < m_dimension; d++) {
+            if (++cell_index[d] < m_axes[d].n_cells)
+                break;
+            cell_index[d] = 0;
+        }
+    }
+}
+
+std::vector<float> MultilinearInterpolation::evaluate(const std::vector<float>& variables) const {
+    float t[3] = {0, 0, 0};
+
+    std::size_t cell = 0;
+    std::size_t stride = 1;
+    for (std::size_t d = 0; d < m_dimension; d++) {
+        const Axis& axis = m_axes[d];
+
+        if (axis.centres.size() > 1) {
+            // NaN goes to the first bin, like in Histogram::findClosestBin
+            float value = variables[d];
+            if (!(value >= axis.centres.front()))
+                value = axis.centres.front();
+            else if (value > axis.centres.back())
+                value = axis.centres.back();
+
+            std::size_t index = std::upper_bound(axis.centres.begin(), axis.centres.end(), value) - axis.centres.begin();
+            index = std::min(std::max<std::size_t>(index, 1), axis.n_cells) - 1;
+
+            t[d] = (value - axis.centres[index]) * axis.inverse_widths[index];
+            cell += index * stride;
+        }
+
+        stride *= axis.n_cells;
+    }
+
+    const float* coefficients = &m_coefficients[cell * m_n_quantities * m_n_corners];
+
+    std::vector<float> result(m_n_quantities);
+    for (std::size_t q = 0; q < m_n_quantities; q++) {
+        float c[8];
+        std::copy(coefficients + q * m_n_corners, coefficients + (q + 1) * m_n_corners, c);
+
+        // Horner scheme, starting from the last axis
+        for (std::size_t d = m_dimension; d-- > 0;) {
+            std::size_t half = std::size_t(1) << d;
+            for (std::size_t corner = 0; corner < half; corner++)
+                c[corner] = std::fma(c[corner + half], t[d], c[corner]);
+        }
+
+        result[q] = c[0];
+    }
+
+    return result;
+}
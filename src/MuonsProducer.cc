@@ -30,10 +30,12 @@ void MuonsProducer::produce(edm::Event& event, const edm::EventSetup& eventSetup
 
     double rho = *rho_handle;
 
-    for (auto muon: *muons) {
+    for (size_t index = 0; index < muons->size(); index++) {
+        pat::Muon muon = (*muons)[index];
         if (! pass_cut(muon))
             continue;
         fill_candidate(muon, muon.genParticle());
+        TriggerMatching::store_trigger_matches(event.id(), muon.eta(), muon.phi());
         reco::MuonPFIsolation pfIso = muon.pfIsolationR03();
         computeIsolations_R03(pfIso.sumChargedHadronPt, pfIso.sumNeutralHadronEt, pfIso.sumPhotonEt, pfIso.sumPUPt, muon.pt(), muon.eta(), rho);
 
@@ -54,6 +56,7 @@ void MuonsProducer::produce(edm::Event& event, const edm::EventSetup& eventSetup
         dca.push_back(muon.dB(pat::Muon::PV3D)/muon.edB(pat::Muon::PV3D));
 
         Parameters p {{BinningVariable::Eta, muon.eta()}, {BinningVariable::Pt, muon.pt()}};
+        p.setRandomKey(random_key(event, index));
         ScaleFactors::store_scale_factors(p, event.isRealData());
     }
 }
@@ -1,11 +1,21 @@
 #include <cp3_llbb/Framework/interface/ScaleFactors.h>
-#include <cp3_llbb/Framework/interface/BinnedValuesJSONParser.h>
-#include <cp3_llbb/Framework/interface/WeightedBinnedValues.h>
+#include <cp3_llbb/Framework/interface/ScaleFactorsRegistry.h>
 
+#include <FWCore/Utilities/interface/EDMException.h>
+
+#include <algorithm>
 #include <iostream>
 
 void ScaleFactors::create_branches(const edm::ParameterSet& config) {
 
+    m_deferred = config.getUntrackedParameter<bool>("deferred_scale_factors", false);
+
+    const std::string weighted_mode = config.getUntrackedParameter<std::string>("weighted_scale_factors", "sample");
+    if (weighted_mode != "sample" && weighted_mode != "combine")
+        throw edm::Exception(edm::errors::Configuration, "Invalid value for 'weighted_scale_factors': " + weighted_mode + ". Only 'sample' and 'combine' are supported");
+
+    bool combine = (weighted_mode == "combine");
+
     if (config.existsAs<edm::ParameterSet>("scale_factors", false)) {
         const edm::ParameterSet& scale_factors = config.getUntrackedParameter<edm::ParameterSet>("scale_factors");
         std::vector<std::string> scale_factors_name = scale_factors.getParameterNames();
@@ -17,19 +27,36 @@ void ScaleFactors::create_branches(const edm::ParameterSet& config) {
             // The value can be either a FileInPath for a standard JSON file, or a vector
             // of ParameterSet for weighted values
             if (scale_factors.existsAs<edm::FileInPath>(scale_factor, false)) {
-
-                BinnedValuesJSONParser parser(scale_factors.getUntrackedParameter<edm::FileInPath>(scale_factor).fullPath());
-                m_scale_factors.emplace(scale_factor, std::unique_ptr<BinnedValues>(new BinnedValues(std::move(parser.get_values()))));
+                const auto& file = scale_factors.getUntrackedParameter<edm::FileInPath>(scale_factor);
+                m_scale_factors.emplace(scale_factor, ScaleFactorsRegistry::get().load(file));
                 std::cout << " -> non-weighted." << std::endl;
             } else {
                 const auto& parts = scale_factors.getUntrackedParameter<std::vector<edm::ParameterSet>>(scale_factor);
-                std::unique_ptr<BinnedValues> values(new WeightedBinnedValues(parts));
-                m_scale_factors.emplace(scale_factor, std::move(values));
-                std::cout << " -> weighted (" << parts.size() << " components)." << std::endl;
+                m_scale_factors.emplace(scale_factor, ScaleFactorsRegistry::get().load(parts, combine));
+                std::cout << " -> weighted (" << parts.size() << " components, " << (combine ? "combined" : "sampled") << ")." << std::endl;
+            }
+
+            const auto& components = m_scale_factors[scale_factor]->getComponents();
+            if (! components.empty()) {
+                std::cout << "        Uncertainty components:";
+                for (const auto& component: components)
+                    std::cout << " " << component;
+                std::cout << std::endl;
             }
         }
     }
 
+    for (const auto& sf: m_scale_factors)
+        m_evaluation_order.push_back({sf.second.get(), m_branches[sf.first], m_lookup.add_layout(*sf.second)});
+
+    std::stable_sort(m_evaluation_order.begin(), m_evaluation_order.end(), [](const RegisteredScaleFactor& a, const RegisteredScaleFactor& b) {
+            return a.layout < b.layout;
+        });
+
+#ifdef SF_DEBUG
+    if (! m_scale_factors.empty())
+        std::cout << "    " << m_scale_factors.size() << " scale-factors sharing " << m_lookup.size() << " binning layouts" << std::endl;
+#endif
 }
 
 void ScaleFactors::create_branch(const std::string& scale_factor, const std::string& branch_name) {
@@ -39,15 +66,61 @@ void ScaleFactors::create_branch(const std::string& scale_factor, const std::str
 }
 
 void ScaleFactors::store_scale_factors(const Parameters& parameters, bool isData) {
-    for (const auto& sf: m_scale_factors) {
-        if (isData)
-            (*m_branches[sf.first]).push_back({1., 0., 0.});
-        else
-            (*m_branches[sf.first]).push_back(sf.second->get(parameters));
+    if (m_scale_factors.empty())
+        return;
+
+    if (m_deferred)
+        m_pending.push_back({parameters, isData});
+    else
+        compute_scale_factors(parameters, isData);
+}
+
+void ScaleFactors::evaluate_scale_factors() {
+    // Objects must be evaluated in order to keep the branches aligned with the other ones
+    for (const auto& pending: m_pending)
+        compute_scale_factors(pending.parameters, pending.isData);
+
+    m_pending.clear();
+}
+
+void ScaleFactors::clear_scale_factors() {
+    m_pending.clear();
+}
+
+void ScaleFactors::compute_scale_factors(const Parameters& parameters, bool isData) {
+    if (isData) {
+        for (const auto& sf: m_evaluation_order)
+            sf.branch->push_back(sf.values->getUnitValues());
+
+        return;
     }
+
+    m_lookup.set_parameters(parameters);
+    for (const auto& sf: m_evaluation_order)
+        sf.branch->push_back(m_lookup.get(*sf.values, sf.layout));
 }
 
 float ScaleFactors::get_scale_factor(const std::string& name, size_t index, Variation variation/* = Variation::Nominal*/) {
+    return get_value(name, index, static_cast<size_t>(variation));
+}
+
+float ScaleFactors::get_scale_factor(const std::string& name, size_t index, const std::string& component, Variation variation) {
+    auto values = m_scale_factors.find(name);
+    if (values == m_scale_factors.end())
+        return 0;
+
+    const auto& components = values->second->getComponents();
+    auto it = std::find(components.begin(), components.end(), component);
+    if (it == components.end())
+        return 0;
+
+    return get_value(name, index, componentIndex(it - components.begin(), variation));
+}
+
+float ScaleFactors::get_value(const std::string& name, size_t index, size_t value) {
+    // Analyzers may need the scale-factors before the event is written
+    evaluate_scale_factors();
+
     auto sf = m_branches.find(name);
     if (sf == m_branches.end())
         return 0;
@@ -55,5 +128,5 @@ float ScaleFactors::get_scale_factor(const std::string& name, size_t index, Vari
     if (index >= sf->second->size())
         return 0;
 
-    return (*sf->second)[index][static_cast<size_t>(variation)];
+    return (*sf->second)[index][value];
 }
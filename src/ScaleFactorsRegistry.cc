@@ -0,0 +1,92 @@
+#include <cp3_llbb/Framework/interface/ScaleFactorsRegistry.h>
+#include <cp3_llbb/Framework/interface/BinnedValuesBinaryParser.h>
+#include <cp3_llbb/Framework/interface/BinnedValuesJSONParser.h>
+#include <cp3_llbb/Framework/interface/WeightedBinnedValues.h>
+#include <cp3_llbb/Framework/interface/Tools.h>
+
+#include <boost/filesystem.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+ScaleFactorsRegistry& ScaleFactorsRegistry::get() {
+    static ScaleFactorsRegistry s_registry;
+    return s_registry;
+}
+
+std::string ScaleFactorsRegistry::canonical_path(const std::string& path) {
+    boost::system::error_code error;
+    boost::filesystem::path canonical = boost::filesystem::canonical(path, error);
+    if (error)
+        return path;
+
+    return canonical.string();
+}
+
+template <typename Factory>
+std::shared_ptr<const BinnedValues> ScaleFactorsRegistry::get_or_create(const std::string& key, Factory factory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_requests++;
+
+    auto it = m_scale_factors.find(key);
+    if (it != m_scale_factors.end())
+        return it->second;
+
+    auto start = clock::now();
+    std::shared_ptr<const BinnedValues> values = factory();
+    m_loading_time += clock::now() - start;
+
+    m_scale_factors.emplace(key, values);
+
+    return values;
+}
+
+std::shared_ptr<const BinnedValues> ScaleFactorsRegistry::load(const edm::FileInPath& file) {
+    const std::string path = canonical_path(file.fullPath());
+
+    return get_or_create(path, [&path]() {
+            if (BinnedValuesBinaryParser::is_binary_file(path)) {
+                BinnedValuesBinaryParser parser(path);
+                return std::make_shared<const BinnedValues>(std::move(parser.get_values()));
+            }
+
+            BinnedValuesJSONParser parser(path);
+            return std::make_shared<const BinnedValues>(std::move(parser.get_values()));
+        });
+}
+
+std::shared_ptr<const BinnedValues> ScaleFactorsRegistry::load(const std::vector<edm::ParameterSet>& parts, bool combine/* = false*/) {
+    // The key must identify the full weighting configuration: same files with different
+    // weights are different scale-factors
+    std::stringstream key;
+    key << std::setprecision(std::numeric_limits<double>::max_digits10) << (combine ? "combined:" : "weighted:");
+    for (const auto& p: parts) {
+        key << canonical_path(p.getUntrackedParameter<edm::FileInPath>("file").fullPath())
+            << "|" << p.getUntrackedParameter<double>("weight") << ";";
+    }
+
+    if (combine) {
+        return get_or_create(key.str(), [&parts]() {
+                CombinedBinnedValues combined(parts);
+                return std::make_shared<const BinnedValues>(std::move(combined.get_values()));
+            });
+    }
+
+    return get_or_create(key.str(), [&parts]() -> std::shared_ptr<const BinnedValues> {
+            return std::make_shared<const WeightedBinnedValues>(parts);
+        });
+}
+
+void ScaleFactorsRegistry::print_summary() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_requests == 0)
+        return;
+
+    std::cout << "Scale-factors registry: " << m_scale_factors.size() << " scale-factors loaded in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(m_loading_time).count() / 1000.
+        << "s, " << (m_requests - m_scale_factors.size()) << " of " << m_requests << " requests served from cache (RSS: " << Tools::process_mem_usage() << " MB)" << std::endl;
+}
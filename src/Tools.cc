@@ -3,6 +3,8 @@
 
 #include <fstream>
 
+#include <unistd.h>
+
 namespace Tools {
     namespace Jets {
 
@@ -0,0 +1,233 @@
+#include <cp3_llbb/Framework/interface/TriggerMatching.h>
+
+#include <FWCore/Utilities/interface/EDMException.h>
+#include <DataFormats/Math/interface/deltaR.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    // Objects beyond are put in the first or last cell
+    const float GRID_MAX_ETA = 10;
+
+    const std::size_t MAX_FILTERS = 64;
+    const std::size_t MAX_FILTER_LABELS = 64;
+}
+
+bool TriggerObjectsIndex::Filter::operator==(const Filter& other) const {
+    return pdg_ids == other.pdg_ids && paths == other.paths && filter_labels == other.filter_labels && max_delta_r == other.max_delta_r;
+}
+
+TriggerObjectsIndex& TriggerObjectsIndex::get() {
+    static TriggerObjectsIndex s_instance;
+    return s_instance;
+}
+
+std::size_t TriggerObjectsIndex::add_filter(const Filter& filter) {
+    for (std::size_t i = 0; i < m_filters.size(); i++) {
+        if (m_filters[i].filter == filter)
+            return i;
+    }
+
+    if (m_filters.size() == MAX_FILTERS)
+        throw edm::Exception(edm::errors::Configuration, "Too many different trigger matching filters (maximum " + std::to_string(MAX_FILTERS) + ")");
+
+    if (filter.max_delta_r <= 0)
+        throw edm::Exception(edm::errors::Configuration, "The maximal ΔR of trigger matching must be positive");
+
+    FilterData data;
+    data.filter = filter;
+
+    HLTService::PathVector paths;
+    for (const auto& path: filter.paths)
+        paths.push_back(HLTService::PathName(path, boost::regex_constants::icase));
+    data.paths = HLTService::PathSet(paths);
+
+    for (const auto& label: filter.filter_labels) {
+        auto it = m_filter_labels.find(label);
+        if (it == m_filter_labels.end()) {
+            if (m_filter_labels.size() == MAX_FILTER_LABELS)
+                throw edm::Exception(edm::errors::Configuration, "Too many different filter labels for trigger matching (maximum " + std::to_string(MAX_FILTER_LABELS) + ")");
+
+            it = m_filter_labels.emplace(label, uint64_t(1) << m_filter_labels.size()).first;
+        }
+
+        data.filter_labels |= it->second;
+    }
+
+    // Cells are at least as large as the maximal ΔR: matches are always in the neighbouring cells
+    data.n_eta = std::max<std::size_t>(1, std::floor(2 * GRID_MAX_ETA / filter.max_delta_r));
+    data.n_phi = std::max<std::size_t>(1, std::floor(2 * M_PI / filter.max_delta_r));
+
+    m_filters.push_back(std::move(data));
+    return m_filters.size() - 1;
+}
+
+void TriggerObjectsIndex::reset(const edm::EventID& event, const std::vector<std::string>* menu) {
+    m_event = event;
+    m_generation++;
+    m_filled = true;
+    m_objects.clear();
+
+    // Paths selected by each filter, only evaluated when the menu changes
+    for (auto& data: m_filters) {
+        if (data.filter.paths.empty() || data.menu == menu)
+            continue;
+
+        data.menu = menu;
+        data.menu_paths.assign(menu->size(), false);
+        for (std::size_t i = 0; i < menu->size(); i++)
+            data.menu_paths[i] = data.paths.matches((*menu)[i]);
+    }
+}
+
+void TriggerObjectsIndex::add_object(float eta, float phi, int pdg_id, const std::vector<std::size_t>& paths, const std::vector<std::string>& filter_labels) {
+    uint64_t labels = 0;
+    if (! m_filter_labels.empty()) {
+        for (const auto& label: filter_labels) {
+            auto it = m_filter_labels.find(label);
+            if (it != m_filter_labels.end())
+                labels |= it->second;
+        }
+    }
+
+    Object object {eta, phi, 0};
+    for (std::size_t i = 0; i < m_filters.size(); i++) {
+        const auto& data = m_filters[i];
+        const auto& filter = data.filter;
+
+        if (! filter.pdg_ids.empty() && std::find(filter.pdg_ids.begin(), filter.pdg_ids.end(), std::abs(pdg_id)) == filter.pdg_ids.end())
+            continue;
+
+        if (data.filter_labels && ! (labels & data.filter_labels))
+            continue;
+
+        if (! filter.paths.empty() && std::none_of(paths.begin(), paths.end(), [&data](std::size_t path) { return data.menu_paths[path]; }))
+            continue;
+
+        object.filters |= uint64_t(1) << i;
+    }
+
+    m_objects.push_back(object);
+}
+
+std::size_t TriggerObjectsIndex::eta_bin(const FilterData& data, float eta) const {
+    float x = (std::min(std::max(eta, -GRID_MAX_ETA), GRID_MAX_ETA) + GRID_MAX_ETA) / (2 * GRID_MAX_ETA);
+    return std::min<std::size_t>(x * data.n_eta, data.n_eta - 1);
+}
+
+std::size_t TriggerObjectsIndex::phi_bin(const FilterData& data, float phi) const {
+    float x = (phi + M_PI) / (2 * M_PI);
+    x -= std::floor(x);
+    return std::min<std::size_t>(x * data.n_phi, data.n_phi - 1);
+}
+
+uint32_t TriggerObjectsIndex::cell(const FilterData& data, std::size_t eta, std::size_t phi) const {
+    return eta * data.n_phi + phi;
+}
+
+void TriggerObjectsIndex::build_grid(FilterData& data) {
+    std::size_t filter = &data - &m_filters[0];
+
+    data.cells.clear();
+    for (std::size_t i = 0; i < m_objects.size(); i++) {
+        const Object& object = m_objects[i];
+        if (! (object.filters & (uint64_t(1) << filter)))
+            continue;
+
+        data.cells.emplace_back(cell(data, eta_bin(data, object.eta), phi_bin(data, object.phi)), i);
+    }
+
+    std::sort(data.cells.begin(), data.cells.end());
+    data.generation = m_generation;
+}
+
+std::pair<int, float> TriggerObjectsIndex::match(std::size_t filter, const edm::EventID& event, float eta, float phi) {
+    if (! m_filled || m_event != event)
+        throw edm::Exception(edm::errors::LogicError, "Trigger matching needs the trigger objects of the event. The 'hlt' producer must run before the producers using trigger matching.");
+
+    FilterData& data = m_filters[filter];
+    if (data.generation != m_generation)
+        build_grid(data);
+
+    int best = -1;
+    float best_delta_r2 = data.filter.max_delta_r * data.filter.max_delta_r;
+
+    std::size_t center_eta = eta_bin(data, eta);
+    std::size_t center_phi = phi_bin(data, phi);
+
+    std::size_t first_eta = center_eta > 0 ? center_eta - 1 : 0;
+    std::size_t last_eta = std::min(center_eta + 1, data.n_eta - 1);
+
+    // With less than three cells in phi, all of them are neighbours
+    std::size_t phi_bins[3] = {(center_phi + data.n_phi - 1) % data.n_phi, center_phi, (center_phi + 1) % data.n_phi};
+    std::size_t n_phi_bins = 3;
+    if (data.n_phi < 3) {
+        for (std::size_t i = 0; i < data.n_phi; i++)
+            phi_bins[i] = i;
+        n_phi_bins = data.n_phi;
+    }
+
+    for (std::size_t eta_index = first_eta; eta_index <= last_eta; eta_index++) {
+        for (std::size_t p = 0; p < n_phi_bins; p++) {
+            uint32_t key = cell(data, eta_index, phi_bins[p]);
+            auto range = std::equal_range(data.cells.begin(), data.cells.end(), std::make_pair(key, uint16_t(0)),
+                    [](const std::pair<uint32_t, uint16_t>& a, const std::pair<uint32_t, uint16_t>& b) {
+                        return a.first < b.first;
+                    });
+
+            for (auto it = range.first; it != range.second; ++it) {
+                const Object& object = m_objects[it->second];
+                float delta_r2 = reco::deltaR2(eta, phi, object.eta, object.phi);
+
+                // Ties go to the first object, like a linear scan would do
+                if (delta_r2 < best_delta_r2 || (delta_r2 == best_delta_r2 && (best < 0 || it->second < best))) {
+                    best = it->second;
+                    best_delta_r2 = delta_r2;
+                }
+            }
+        }
+    }
+
+    if (best < 0)
+        return {-1, -1};
+
+    return {best, std::sqrt(best_delta_r2)};
+}
+
+void TriggerMatching::create_branches(const edm::ParameterSet& config) {
+
+    if (! config.existsAs<edm::ParameterSet>("trigger_matching", false))
+        return;
+
+    const edm::ParameterSet& trigger_matching = config.getUntrackedParameter<edm::ParameterSet>("trigger_matching");
+    for (const std::string& name: trigger_matching.getParameterNames()) {
+        const edm::ParameterSet& matcher_set = trigger_matching.getUntrackedParameterSet(name);
+
+        TriggerObjectsIndex::Filter filter;
+        filter.pdg_ids = matcher_set.getUntrackedParameter<std::vector<int>>("pdg_id", std::vector<int>());
+        for (auto& pdg_id: filter.pdg_ids)
+            pdg_id = std::abs(pdg_id);
+        filter.paths = matcher_set.getUntrackedParameter<std::vector<std::string>>("paths", std::vector<std::string>());
+        filter.filter_labels = matcher_set.getUntrackedParameter<std::vector<std::string>>("filters", std::vector<std::string>());
+        filter.max_delta_r = matcher_set.getUntrackedParameter<double>("max_delta_r", 0.3);
+
+        std::cout << "    Registering new trigger matching: " << name << std::endl;
+
+        Matcher matcher;
+        matcher.filter = TriggerObjectsIndex::get().add_filter(filter);
+        matcher.indices = &m_tree["hlt_" + name + "_idx"].write<std::vector<int16_t>>();
+        matcher.delta_r = &m_tree["hlt_" + name + "_deltaR"].write<std::vector<float>>();
+
+        m_matchers.push_back(matcher);
+    }
+}
+
+void TriggerMatching::store_trigger_matches(const edm::EventID& event, float eta, float phi) {
+    for (auto& matcher: m_matchers) {
+        auto match = TriggerObjectsIndex::get().match(matcher.filter, event, eta, phi);
+        matcher.indices->push_back(match.first);
+        matcher.delta_r->push_back(match.second);
+    }
+}
@@ -1,23 +1,240 @@
 #include <cp3_llbb/Framework/interface/WeightedBinnedValues.h>
 
+#include <cp3_llbb/Framework/interface/BinnedValuesBinaryParser.h>
 #include <cp3_llbb/Framework/interface/BinnedValuesJSONParser.h>
 
+#ifndef STANDALONE_SCALEFACTORS
+#include <FWCore/Utilities/interface/EDMException.h>
+#endif
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+#ifndef STANDALONE_SCALEFACTORS
+    std::vector<WeightedBinnedValues::part_type> to_parts(const std::vector<edm::ParameterSet>& parts) {
+        std::vector<WeightedBinnedValues::part_type> result;
+        for (const auto& p: parts)
+            result.emplace_back(p.getUntrackedParameter<edm::FileInPath>("file").fullPath(), p.getUntrackedParameter<double>("weight"));
+
+        return result;
+    }
+#endif
+
+    std::string filename(const std::string& path) {
+        size_t slash = path.rfind('/');
+        return (slash == std::string::npos) ? path : path.substr(slash + 1);
+    }
+
+    BinnedValues load(const std::string& file) {
+        if (BinnedValuesBinaryParser::is_binary_file(file)) {
+            BinnedValuesBinaryParser parser(file);
+            return std::move(parser.get_values());
+        }
+
+        BinnedValuesJSONParser parser(file);
+        return std::move(parser.get_values());
+    }
+
+    [[noreturn]] void incompatible(const std::string& message) {
+#ifdef STANDALONE_SCALEFACTORS
+        throw std::logic_error(message);
+#else
+        throw edm::Exception(edm::errors::LogicError, message);
+#endif
+    }
+}
+
+#ifndef STANDALONE_SCALEFACTORS
 WeightedBinnedValues::WeightedBinnedValues(const std::vector<edm::ParameterSet>& parts):
-    random_generator(42) {
+    WeightedBinnedValues(to_parts(parts)) {
+    // Empty
+}
+#endif
 
-    std::vector<double> weights;
+WeightedBinnedValues::WeightedBinnedValues(const std::vector<part_type>& parts) {
+
+    // Draws for different weighted values must be independent. The purpose is built from
+    // the file names and not the full paths, so that results do not depend on where the job runs
+    std::stringstream purpose;
+    purpose << "WeightedBinnedValues";
 
+    double sum = 0;
     for (const auto& p: parts) {
-        double weight = p.getUntrackedParameter<double>("weight");
-        weights.push_back(weight);
+        const std::string& file = p.first;
+        double weight = p.second;
+        sum += weight;
+        cumulative_weights.push_back(sum);
 
-        BinnedValuesJSONParser parser(p.getUntrackedParameter<edm::FileInPath>("file").fullPath());
-        efficiencies.push_back(std::move(parser.get_values()));
+        purpose << ";" << filename(file) << "|" << weight;
+
+        efficiencies.push_back(load(file));
+    }
+
+    for (auto& w: cumulative_weights)
+        w /= sum;
+
+    // Values of any component may be returned: they must all provide the same uncertainty components
+    components = efficiencies.front().getComponents();
+    for (const auto& e: efficiencies) {
+        if (e.getComponents() != components)
+            incompatible("All the weighted files must provide the same uncertainty components");
     }
 
-    probability_distribution.reset(new std::discrete_distribution<>(weights.begin(), weights.end()));
+    random_purpose = CounterBasedRandom::purpose(purpose.str());
 }
 
 std::vector<float> WeightedBinnedValues::get(const Parameters& parameters) const {
-    return efficiencies[(*probability_distribution)(random_generator)].get(parameters);
+    RandomKey key;
+    if (parameters.hasRandomKey())
+        key = parameters.getRandomKey();
+    else
+        key.event = calls_without_key++;
+
+    key.purpose = random_purpose;
+
+    double u = CounterBasedRandom::uniform(key)[0];
+    size_t index = std::upper_bound(cumulative_weights.begin(), cumulative_weights.end(), u) - cumulative_weights.begin();
+
+    // Protect against rounding errors in the normalization
+    index = std::min(index, efficiencies.size() - 1);
+
+    return efficiencies[index].get(parameters);
+}
+
+#ifndef STANDALONE_SCALEFACTORS
+CombinedBinnedValues::CombinedBinnedValues(const std::vector<edm::ParameterSet>& parts):
+    CombinedBinnedValues(to_parts(parts)) {
+    // Empty
+}
+#endif
+
+CombinedBinnedValues::CombinedBinnedValues(const std::vector<WeightedBinnedValues::part_type>& parts) {
+
+    if (parts.empty())
+        incompatible("No values to combine");
+
+    std::vector<BinnedValues> values;
+    std::vector<double> weights;
+    double sum = 0;
+    for (const auto& p: parts) {
+        values.push_back(load(p.first));
+        weights.push_back(p.second);
+        sum += p.second;
+    }
+
+    for (auto& w: weights)
+        w /= sum;
+
+    const BinnedValues& first = values.front();
+    for (const auto& v: values) {
+        if (v.use_formula)
+            incompatible("Values described by formulas cannot be combined");
+
+        if (v.binning_variables != first.binning_variables)
+            incompatible("Combined values must depend on the same variables");
+
+        if (v.components != first.components)
+            incompatible("Combined values must provide the same uncertainty components");
+
+        if (bool(v.interpolation) != bool(first.interpolation))
+            incompatible("Combined values must all be interpolated, or none of them");
+
+        // Interpolating values sampled on the union of the binnings is not the weighted average
+        // of the interpolated values
+        if (first.interpolation && v.getBinning() != first.getBinning())
+            incompatible("Interpolated values can only be combined if they have the same binning");
+    }
+
+    // Common binning: union of the bin edges of all the values
+    std::vector<std::vector<float>> binning = first.getBinning();
+    for (const auto& v: values) {
+        std::vector<std::vector<float>> other = v.getBinning();
+        for (size_t d = 0; d < binning.size(); d++)
+            binning[d].insert(binning[d].end(), other[d].begin(), other[d].end());
+    }
+
+    for (auto& edges: binning) {
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    }
+
+    m_values.binning_variables = first.binning_variables;
+    m_values.components = first.components;
+    m_values.error_type = BinnedValues::ErrorType::ABSOLUTE;
+    m_values.minimum = first.minimum;
+    m_values.maximum = first.maximum;
+    for (const auto& v: values) {
+        m_values.minimum = std::min(m_values.minimum, v.minimum);
+        m_values.maximum = std::max(m_values.maximum, v.maximum);
+    }
+
+    switch (binning.size()) {
+        case 1:
+            m_values.binned.reset(new OneDimensionHistogram<float>(binning[0]));
+            break;
+
+        case 2:
+            m_values.binned.reset(new TwoDimensionsHistogram<float>(binning[0], binning[1]));
+            break;
+
+        case 3:
+            m_values.binned.reset(new ThreeDimensionsHistogram<float>(binning[0], binning[1], binning[2]));
+            break;
+
+        default:
+            incompatible("Invalid dimension for combined values");
+    }
+
+    size_t n_component_errors = 2 * m_values.components.size();
+    size_t n_bins = m_values.binned->size();
+
+    std::shared_ptr<float> component_storage(new float[std::max<size_t>(n_component_errors * n_bins, 1)](), std::default_delete<float[]>());
+    float* component_errors = component_storage.get();
+
+    // Evaluate each set of values at the centre of every bin of the common binning, x running fastest
+    std::vector<size_t> index(binning.size(), 0);
+    for (size_t bin = 1; bin <= n_bins; bin++) {
+        Parameters parameters;
+        for (size_t d = 0; d < binning.size(); d++)
+            parameters.set(m_values.binning_variables[d], (binning[d][index[d]] + binning[d][index[d] + 1]) / 2.);
+
+        std::vector<double> combined(3 + n_component_errors, 0.);
+        for (size_t i = 0; i < values.size(); i++) {
+            // A set with a narrower range than the common binning uses its closest bin, without
+            // doubling the errors: the combined values double them outside the common range only
+            ResolvedBin resolved;
+            values[i].resolve(parameters, resolved);
+            resolved.outOfRange = false;
+
+            std::vector<float> v = values[i].get(resolved);
+            for (size_t j = 0; j < combined.size(); j++)
+                combined[j] += weights[i] * v[j];
+        }
+
+        m_values.binned->setBinContent(bin, combined[Nominal]);
+        m_values.binned->setBinErrorLow(bin, combined[Down]);
+        m_values.binned->setBinErrorHigh(bin, combined[Up]);
+        std::copy(combined.begin() + 3, combined.end(), component_errors + (bin - 1) * n_component_errors);
+
+        for (size_t d = 0; d < binning.size(); d++) {
+            if (++index[d] < binning[d].size() - 1)
+                break;
+            index[d] = 0;
+        }
+    }
+
+    if (n_component_errors) {
+        m_values.component_errors = component_errors;
+        m_values.component_storage = component_storage;
+    }
+
+    if (first.interpolation)
+        m_values.interpolation.reset(new MultilinearInterpolation(*m_values.binned, m_values.component_errors, n_component_errors));
+
+    std::string files;
+    for (const auto& p: parts)
+        files += (files.empty() ? "" : ", ") + p.first;
+
+    m_values.validate("combination of " + files);
 }
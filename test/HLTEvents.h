@@ -0,0 +1,206 @@
+/**
+ * Text format of the trigger products recorded by test/HLTEventsDumper.cc and replayed by
+ * test/benchmarkHLT.cc, shared by both so that they cannot drift apart. See test/testHLTEvents.cc.
+ *
+ * One item per line:
+ *
+ *   menu <id> <number of paths>          For each new menu, followed by one path name per line
+ *   event <run> <lumi> <event> <menu id>
+ *   <accept bit of each path, as a string of 0 and 1>
+ *   <prescale of each path, space separated, or '-' if the event has no prescales>
+ *   <number of objects>                   Followed by one line per object:
+ *   <pt> <eta> <phi> <energy> <pdg id> <n> <trigger index of the n paths> <m> <the m filter labels>
+ *
+ * Only standard types are used: the dumper fills them from the CMSSW products, the benchmark
+ * builds the stand-in products from them.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace hlt_events {
+
+    struct Object {
+        float pt;
+        float eta;
+        float phi;
+        float energy;
+        int pdg_id;
+        std::vector<uint16_t> paths;
+        std::vector<std::string> filter_labels;
+    };
+
+    struct Event {
+        uint32_t run;
+        uint32_t lumi;
+        uint64_t event;
+        size_t menu;
+        std::vector<bool> accept;
+        bool has_prescales = false;
+        std::vector<int> prescales;
+        std::vector<Object> objects;
+    };
+
+    struct Sample {
+        // Path names of each menu, by identifier
+        std::map<size_t, std::vector<std::string>> menus;
+        std::vector<Event> events;
+    };
+
+    class Writer {
+        public:
+            Writer(std::ostream& out): m_out(out) {
+                m_out.precision(std::numeric_limits<float>::max_digits10);
+            }
+
+            void write_menu(size_t id, const std::vector<std::string>& names) {
+                m_out << "menu " << id << " " << names.size() << "\n";
+                for (const auto& name: names)
+                    m_out << name << "\n";
+            }
+
+            void write_event(const Event& event) {
+                m_out << "event " << event.run << " " << event.lumi << " " << event.event << " " << event.menu << "\n";
+
+                for (bool accept: event.accept)
+                    m_out << (accept ? '1' : '0');
+                m_out << "\n";
+
+                if (event.has_prescales) {
+                    for (size_t i = 0; i < event.prescales.size(); i++)
+                        m_out << (i ? " " : "") << event.prescales[i];
+                    m_out << "\n";
+                } else {
+                    m_out << "-\n";
+                }
+
+                m_out << event.objects.size() << "\n";
+                for (const auto& object: event.objects) {
+                    m_out << object.pt << " " << object.eta << " " << object.phi << " " << object.energy << " " << object.pdg_id;
+
+                    m_out << " " << object.paths.size();
+                    for (uint16_t path: object.paths)
+                        m_out << " " << path;
+
+                    m_out << " " << object.filter_labels.size();
+                    for (const auto& label: object.filter_labels)
+                        m_out << " " << label;
+
+                    m_out << "\n";
+                }
+            }
+
+        private:
+            std::ostream& m_out;
+    };
+
+    /**
+     * Read everything written by a Writer to @p in. @p name is only used in the error messages.
+     */
+    inline Sample read(std::istream& in, const std::string& name) {
+        Sample sample;
+
+        auto error = [&name](const std::string& what) {
+            return std::runtime_error("Invalid HLT events file " + name + ": " + what);
+        };
+
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string type;
+            fields >> type;
+
+            if (type == "menu") {
+                size_t id, n_paths;
+                if (! (fields >> id >> n_paths))
+                    throw error("invalid menu '" + line + "'");
+
+                std::vector<std::string> names(n_paths);
+                for (auto& name: names) {
+                    if (! std::getline(in, name))
+                        throw error("unexpected end of file in menu " + std::to_string(id));
+                }
+
+                sample.menus[id] = std::move(names);
+
+            } else if (type == "event") {
+                Event event;
+                if (! (fields >> event.run >> event.lumi >> event.event >> event.menu) || ! sample.menus.count(event.menu))
+                    throw error("invalid event '" + line + "'");
+
+                const std::string number = std::to_string(event.event);
+                size_t n_paths = sample.menus[event.menu].size();
+
+                std::string accept;
+                if (! std::getline(in, accept) || accept.size() != n_paths || accept.find_first_not_of("01") != std::string::npos)
+                    throw error("invalid trigger results for event " + number);
+
+                event.accept.resize(n_paths);
+                for (size_t i = 0; i < n_paths; i++)
+                    event.accept[i] = accept[i] == '1';
+
+                std::string prescales;
+                if (! std::getline(in, prescales))
+                    throw error("missing prescales for event " + number);
+
+                event.has_prescales = prescales != "-";
+                if (event.has_prescales) {
+                    std::istringstream values(prescales);
+                    event.prescales.resize(n_paths);
+                    for (auto& prescale: event.prescales) {
+                        if (! (values >> prescale))
+                            throw error("invalid prescales for event " + number);
+                    }
+                }
+
+                std::string n_objects_line;
+                size_t n_objects;
+                if (! std::getline(in, n_objects_line) || ! (std::istringstream(n_objects_line) >> n_objects))
+                    throw error("missing trigger objects for event " + number);
+
+                event.objects.resize(n_objects);
+                for (auto& object: event.objects) {
+                    std::string object_line;
+                    if (! std::getline(in, object_line))
+                        throw error("missing trigger objects for event " + number);
+
+                    std::istringstream fields(object_line);
+                    size_t n_indices, n_labels;
+                    if (! (fields >> object.pt >> object.eta >> object.phi >> object.energy >> object.pdg_id >> n_indices))
+                        throw error("invalid trigger object for event " + number);
+
+                    object.paths.resize(n_indices);
+                    for (auto& index: object.paths) {
+                        if (! (fields >> index) || index >= n_paths)
+                            throw error("invalid trigger object paths for event " + number);
+                    }
+
+                    if (! (fields >> n_labels))
+                        throw error("invalid trigger object for event " + number);
+
+                    object.filter_labels.resize(n_labels);
+                    for (auto& label: object.filter_labels) {
+                        if (! (fields >> label))
+                            throw error("invalid trigger object filters for event " + number);
+                    }
+                }
+
+                sample.events.push_back(std::move(event));
+
+            } else if (! type.empty()) {
+                throw error("unexpected line '" + line + "'");
+            }
+        }
+
+        return sample;
+    }
+}
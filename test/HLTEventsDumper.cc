@@ -0,0 +1,105 @@
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Common/interface/TriggerNames.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+
+#include <DataFormats/Common/interface/TriggerResults.h>
+#include <DataFormats/PatCandidates/interface/PackedTriggerPrescales.h>
+#include <DataFormats/PatCandidates/interface/TriggerObjectStandAlone.h>
+
+#include "HLTEvents.h"
+
+#include <fstream>
+#include <map>
+
+/**
+ * Write the trigger products read by the hlt producer (TriggerResults, their TriggerNames,
+ * PackedTriggerPrescales and TriggerObjectStandAlone) to a text file, replayed outside CMSSW by
+ * test/benchmarkHLT.cc. See test/HLTEvents.h for the format, and test/dump_hlt_events.py.
+ *
+ * Only needed to record the input of the benchmark: built as a test plugin, see test/BuildFile.xml.
+ */
+class HLTEventsDumper: public edm::EDAnalyzer {
+    public:
+        explicit HLTEventsDumper(const edm::ParameterSet& config):
+            m_output(config.getUntrackedParameter<std::string>("output")), m_writer(m_output) {
+
+            if (! m_output)
+                throw edm::Exception(edm::errors::Configuration, "Failed to open " + config.getUntrackedParameter<std::string>("output"));
+
+            m_hlt_token = consumes<edm::TriggerResults>(config.getUntrackedParameter<edm::InputTag>("hlt", edm::InputTag("TriggerResults", "", "HLT")));
+            m_prescales_token = consumes<pat::PackedTriggerPrescales>(config.getUntrackedParameter<edm::InputTag>("prescales", edm::InputTag("patTrigger")));
+            m_trigger_objects_token = consumes<pat::TriggerObjectStandAloneCollection>(config.getUntrackedParameter<edm::InputTag>("objects", edm::InputTag("selectedPatTrigger")));
+        }
+
+    private:
+        virtual void analyze(const edm::Event& event, const edm::EventSetup&) override;
+
+        edm::EDGetTokenT<edm::TriggerResults> m_hlt_token;
+        edm::EDGetTokenT<pat::PackedTriggerPrescales> m_prescales_token;
+        edm::EDGetTokenT<pat::TriggerObjectStandAloneCollection> m_trigger_objects_token;
+
+        std::ofstream m_output;
+        hlt_events::Writer m_writer;
+
+        // Identifier in the output of the menus already written
+        std::map<edm::ParameterSetID, size_t> m_menus;
+};
+
+void HLTEventsDumper::analyze(const edm::Event& event, const edm::EventSetup&) {
+
+    edm::Handle<edm::TriggerResults> hlt;
+    event.getByToken(m_hlt_token, hlt);
+
+    const edm::TriggerNames& triggerNames = event.triggerNames(*hlt);
+
+    auto menu = m_menus.find(triggerNames.parameterSetID());
+    if (menu == m_menus.end()) {
+        menu = m_menus.emplace(triggerNames.parameterSetID(), m_menus.size()).first;
+        m_writer.write_menu(menu->second, triggerNames.triggerNames());
+    }
+
+    hlt_events::Event recorded;
+    recorded.run = event.id().run();
+    recorded.lumi = event.id().luminosityBlock();
+    recorded.event = event.id().event();
+    recorded.menu = menu->second;
+
+    for (size_t i = 0; i < triggerNames.size(); i++)
+        recorded.accept.push_back(hlt->accept(i));
+
+    edm::Handle<pat::PackedTriggerPrescales> prescales;
+    event.getByToken(m_prescales_token, prescales);
+
+    recorded.has_prescales = prescales.isValid();
+    if (recorded.has_prescales) {
+        for (size_t i = 0; i < triggerNames.size(); i++)
+            recorded.prescales.push_back(prescales->getPrescaleForIndex(i));
+    }
+
+    edm::Handle<pat::TriggerObjectStandAloneCollection> objects;
+    event.getByToken(m_trigger_objects_token, objects);
+
+    if (objects.isValid()) {
+        for (pat::TriggerObjectStandAlone obj: *objects) {
+            obj.unpackPathNames(triggerNames);
+
+            hlt_events::Object object {static_cast<float>(obj.pt()), static_cast<float>(obj.eta()), static_cast<float>(obj.phi()),
+                static_cast<float>(obj.energy()), obj.pdgId(), {}, obj.filterLabels()};
+
+            // Paths are stored as trigger indices in MiniAOD too
+            for (const auto& path: obj.pathNames(false))
+                object.paths.push_back(triggerNames.triggerIndex(path));
+
+            recorded.objects.push_back(std::move(object));
+        }
+    }
+
+    m_writer.write_event(recorded);
+}
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+DEFINE_FWK_MODULE(HLTEventsDumper);
@@ -0,0 +1,44 @@
+/**
+ * Temporary file holding the input of a unit test, shared by the standalone tests.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * Write @p content, unchanged, to a new file in /tmp, removed when the object goes out of scope
+ */
+class TemporaryFile {
+    public:
+        TemporaryFile(const std::string& content) {
+            char name[] = "/tmp/cp3_llbbXXXXXX";
+            int fd = mkstemp(name);
+            if (fd < 0)
+                throw std::runtime_error("Failed to create a temporary file");
+
+            close(fd);
+            m_path = name;
+
+            std::ofstream(m_path, std::ios::binary) << content;
+        }
+
+        TemporaryFile(const TemporaryFile&) = delete;
+        TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+        ~TemporaryFile() {
+            unlink(m_path.c_str());
+        }
+
+        const std::string& path() const {
+            return m_path;
+        }
+
+    private:
+        std::string m_path;
+};
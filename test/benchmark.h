@@ -0,0 +1,302 @@
+/**
+ * Minimal benchmark harness, with the interface of Google Benchmark, shared by the standalone
+ * benchmarks (benchmarkScaleFactors, benchmarkHLT).
+ *
+ * Each benchmark reports the time and the number of heap allocations per unit of work (a lookup,
+ * an event, ...). Results can be saved, and compared with a previous run to check the effect of
+ * a change:
+ *
+ *   benchmarkXXX --benchmark_out=before.tsv
+ *   ... change the code, rebuild ...
+ *   benchmarkXXX --baseline=before.tsv
+ *
+ * Options (same names as Google Benchmark):
+ *
+ *   --benchmark_filter=REGEX       Only run the benchmarks whose name matches REGEX
+ *   --benchmark_min_time=SECONDS   Minimal duration of each measurement (default 0.2)
+ *   --benchmark_repetitions=N      Number of measurements of each benchmark, the median is reported (default 3)
+ *   --benchmark_out=FILE           Save the results to FILE
+ *   --baseline=FILE                Compare the results with the ones saved in FILE
+ *
+ * This header replaces the global allocation operators: include it in a single translation unit
+ * of each benchmark.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * Every heap allocation of the process, including the ones done by the library, goes through these
+ * operators. Benchmarks are single-threaded, so a plain counter is enough.
+ */
+namespace {
+    std::size_t allocations = 0;
+
+    void* counted_malloc(std::size_t size) {
+        allocations++;
+        if (void* p = std::malloc(size ? size : 1))
+            return p;
+
+        throw std::bad_alloc();
+    }
+}
+
+// Scalar and array forms are all replaced, so that every allocation is counted and freed the same way
+void* operator new(std::size_t size) {
+    return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_malloc(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace benchmark {
+
+    /**
+     * Prevent the compiler from optimizing away the computation of @p value
+     */
+    template <typename T>
+    inline void DoNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    class State {
+        public:
+            State(std::size_t iterations):
+                m_iterations(iterations) {
+                    // Empty
+                }
+
+            std::size_t iterations() const {
+                return m_iterations;
+            }
+
+            /**
+             * Number of lookups done by each iteration, used to normalize the results. Defaults to 1.
+             */
+            void SetLookupsPerIteration(double lookups) {
+                m_lookups = lookups;
+            }
+
+            double lookups() const {
+                return m_lookups;
+            }
+
+        private:
+            std::size_t m_iterations;
+            double m_lookups = 1;
+    };
+
+    struct Result {
+        double ns_per_lookup;
+        double allocations_per_lookup;
+    };
+
+    class Registry {
+        public:
+            typedef std::function<void(State&)> function_type;
+
+            void add(const std::string& name, function_type function) {
+                m_benchmarks.push_back({name, function});
+            }
+
+            void run(const std::regex& filter, double min_time, std::size_t repetitions, std::map<std::string, Result>& results) const {
+                for (const auto& benchmark: m_benchmarks) {
+                    if (! std::regex_search(benchmark.first, filter))
+                        continue;
+
+                    std::vector<Result> measurements;
+                    for (std::size_t r = 0; r < repetitions; r++)
+                        measurements.push_back(measure(benchmark.second, min_time));
+
+                    std::sort(measurements.begin(), measurements.end(), [](const Result& a, const Result& b) {
+                            return a.ns_per_lookup < b.ns_per_lookup;
+                        });
+
+                    results[benchmark.first] = measurements[measurements.size() / 2];
+                }
+            }
+
+            std::size_t name_width() const {
+                std::size_t width = 0;
+                for (const auto& benchmark: m_benchmarks)
+                    width = std::max(width, benchmark.first.size());
+
+                return width;
+            }
+
+        private:
+            /**
+             * Run the benchmark with more and more iterations, until it lasts at least @p min_time seconds
+             */
+            static Result measure(const function_type& function, double min_time) {
+                std::size_t iterations = 1;
+                while (true) {
+                    State state(iterations);
+
+                    std::size_t allocations_before = allocations;
+                    auto start = std::chrono::steady_clock::now();
+                    function(state);
+                    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    std::size_t n_allocations = allocations - allocations_before;
+
+                    if (elapsed.count() >= min_time || iterations >= (std::size_t(1) << 40)) {
+                        double lookups = iterations * state.lookups();
+                        return {elapsed.count() * 1e9 / lookups, n_allocations / lookups};
+                    }
+
+                    // Aim a bit above the minimal time to avoid an extra round
+                    double factor = elapsed.count() > 0 ? 1.4 * min_time / elapsed.count() : 10;
+                    iterations = std::max<std::size_t>(iterations + 1, iterations * std::min(factor, 10.));
+                }
+            }
+
+            std::vector<std::pair<std::string, function_type>> m_benchmarks;
+    };
+
+    inline std::map<std::string, Result> read_results(const std::string& file) {
+        std::ifstream in(file);
+        if (! in.is_open())
+            throw std::runtime_error("Failed to open " + file);
+
+        std::map<std::string, Result> results;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream fields(line);
+            std::string name;
+            Result result;
+            if (std::getline(fields, name, '\t') && fields >> result.ns_per_lookup >> result.allocations_per_lookup)
+                results[name] = result;
+        }
+
+        return results;
+    }
+
+    inline void write_results(const std::string& file, const std::map<std::string, Result>& results) {
+        std::ofstream out(file);
+        if (! out.is_open())
+            throw std::runtime_error("Failed to open " + file);
+
+        out << "# name\tns/lookup\tallocations/lookup" << std::endl;
+        for (const auto& result: results)
+            out << result.first << '\t' << result.second.ns_per_lookup << '\t' << result.second.allocations_per_lookup << std::endl;
+    }
+
+    inline bool parse_option(const std::string& argument, const std::string& option, std::string& value) {
+        std::string prefix = "--" + option + "=";
+        if (argument.compare(0, prefix.size(), prefix) != 0)
+            return false;
+
+        value = argument.substr(prefix.size());
+        return true;
+    }
+
+    struct Options {
+        std::string filter = ".*";
+        double min_time = 0.2;
+        std::size_t repetitions = 3;
+        std::string output;
+        std::string baseline;
+
+        /**
+         * Parse one of the options above. Return false if @p argument is not one of them.
+         */
+        bool parse(const std::string& argument) {
+            std::string value;
+            if (parse_option(argument, "benchmark_filter", value))
+                filter = value;
+            else if (parse_option(argument, "benchmark_min_time", value))
+                min_time = std::stod(value);
+            else if (parse_option(argument, "benchmark_repetitions", value))
+                repetitions = std::max(std::stoul(value), 1ul);
+            else if (parse_option(argument, "benchmark_out", value))
+                output = value;
+            else if (parse_option(argument, "baseline", value))
+                baseline = value;
+            else
+                return false;
+
+            return true;
+        }
+
+        static std::string usage() {
+            return "[--benchmark_filter=REGEX] [--benchmark_min_time=SECONDS] [--benchmark_repetitions=N] [--benchmark_out=FILE] [--baseline=FILE]";
+        }
+    };
+
+    /**
+     * Run the benchmarks of @p registry, print the results, compared with the baseline if any, and
+     * save them if requested. @p unit names the unit of work in the report.
+     */
+    inline std::map<std::string, Result> run(const Registry& registry, const Options& options, const std::string& unit) {
+        std::map<std::string, Result> baseline_results;
+        if (! options.baseline.empty())
+            baseline_results = read_results(options.baseline);
+
+        std::map<std::string, Result> results;
+        registry.run(std::regex(options.filter), options.min_time, options.repetitions, results);
+
+        std::size_t width = registry.name_width() + 2;
+        std::cout << std::left << std::setw(width) << "Benchmark" << std::right << std::setw(12) << ("ns/" + unit) << std::setw(16) << ("allocs/" + unit);
+        if (! options.baseline.empty())
+            std::cout << std::setw(14) << "baseline ns" << std::setw(10) << "change";
+        std::cout << std::endl;
+
+        for (const auto& result: results) {
+            std::cout << std::left << std::setw(width) << result.first << std::right << std::fixed
+                << std::setprecision(1) << std::setw(12) << result.second.ns_per_lookup
+                << std::setprecision(2) << std::setw(16) << result.second.allocations_per_lookup;
+
+            if (! options.baseline.empty()) {
+                auto it = baseline_results.find(result.first);
+                if (it == baseline_results.end())
+                    std::cout << std::setw(14) << "-" << std::setw(10) << "-";
+                else {
+                    double change = 100. * (result.second.ns_per_lookup / it->second.ns_per_lookup - 1);
+                    std::cout << std::setprecision(1) << std::setw(14) << it->second.ns_per_lookup
+                        << std::setw(9) << std::showpos << change << std::noshowpos << "%";
+                }
+            }
+
+            std::cout << std::endl;
+        }
+
+        if (! options.output.empty())
+            write_results(options.output, results);
+
+        return results;
+    }
+}
@@ -0,0 +1,381 @@
+/**
+ * Benchmark of the hlt producer (HLTProducer), outside CMSSW: recorded trigger products (TriggerResults,
+ * TriggerNames, PackedTriggerPrescales and TriggerObjectStandAlone) are replayed through the stand-in
+ * event of test/standin.
+ *
+ * The products are read from test/hlt_events.txt, recorded from the data unit-test input with
+ * test/dump_hlt_events.py (see test/HLTEvents.h for the format), or from the file given with
+ * --events=FILE. Without it, a synthetic sample with a realistic 2016 menu is generated.
+ *
+ * Each event is processed with only the TriggerResults, then with the prescales, then with the trigger
+ * objects. The differences give the cost of the path filtering, of the prescales lookup and of the
+ * object filtering. Everything is measured without path selection, and with the selection of
+ * data/triggers.xml. The time per event includes the creation of the stand-in event and the reset of
+ * the branches, which are part of the path filtering cost.
+ *
+ * See test/benchmark.h for the other options.
+ */
+
+#include "benchmark.h"
+#include "HLTEvents.h"
+
+#include <cp3_llbb/Framework/interface/HLTProducer.h>
+
+#include <FWCore/Framework/interface/Event.h>
+#include <FWCore/Framework/interface/EventSetup.h>
+#include <FWCore/Framework/interface/LuminosityBlock.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    const std::string DATA_DIR = HLT_DATA_DIR;
+    const std::string EVENTS_FILE = HLT_EVENTS_FILE;
+
+    struct RecordedEvent {
+        edm::EventID id;
+        size_t menu;
+        edm::TriggerResults results;
+        bool has_prescales;
+        pat::PackedTriggerPrescales prescales;
+        pat::TriggerObjectStandAloneCollection objects;
+    };
+
+    struct Sample {
+        std::vector<edm::TriggerNames> menus;
+        std::vector<RecordedEvent> events;
+    };
+
+    // Products of the event given to the producer. Each level includes the previous ones.
+    enum class Products {
+        PATHS,
+        PRESCALES,
+        OBJECTS
+    };
+
+    /**
+     * Read a file written by HLTEventsDumper, and build the products of each event
+     */
+    Sample read_sample(const std::string& file) {
+        std::ifstream in(file);
+        if (! in.is_open())
+            throw std::runtime_error("Failed to open " + file);
+
+        hlt_events::Sample recorded = hlt_events::read(in, file);
+        if (recorded.events.empty())
+            throw std::runtime_error("Invalid HLT events file " + file + ": no events");
+
+        Sample sample;
+        std::map<size_t, size_t> menus;
+        for (const auto& menu: recorded.menus) {
+            menus[menu.first] = sample.menus.size();
+            sample.menus.emplace_back(menu.second, edm::ParameterSetID(sample.menus.size() + 1));
+        }
+
+        for (const auto& recorded_event: recorded.events) {
+            RecordedEvent event;
+            event.id = edm::EventID(recorded_event.run, recorded_event.lumi, recorded_event.event);
+            event.menu = menus[recorded_event.menu];
+            event.results = edm::TriggerResults(recorded_event.accept);
+            event.has_prescales = recorded_event.has_prescales;
+            if (event.has_prescales)
+                event.prescales = pat::PackedTriggerPrescales(recorded_event.prescales);
+
+            for (const auto& object: recorded_event.objects)
+                event.objects.emplace_back(object.pt, object.eta, object.phi, object.energy, object.pdg_id, object.paths, object.filter_labels);
+
+            sample.events.push_back(std::move(event));
+        }
+
+        return sample;
+    }
+
+    /**
+     * Paths of a 2016 menu: the paths of data/triggers.xml among about 450 others, with the AlCa
+     * paths and HLTriggerFinalPath that the producer always removes. @p version is added to the
+     * version of every path, to build different menus.
+     */
+    std::vector<std::string> generate_menu(size_t version, std::mt19937& generator) {
+        std::vector<std::string> names = {
+            "HLTriggerFirstPath",
+            "HLT_Mu17_TrkIsoVVL_Mu8_TrkIsoVVL_v",
+            "HLT_Mu17_TrkIsoVVL_TkMu8_TrkIsoVVL_v",
+            "HLT_Mu17_TrkIsoVVL_Mu8_TrkIsoVVL_DZ_v",
+            "HLT_Mu17_TrkIsoVVL_TkMu8_TrkIsoVVL_DZ_v",
+            "HLT_Ele23_Ele12_CaloIdL_TrackIdL_IsoVL_DZ_v",
+            "HLT_Mu23_TrkIsoVVL_Ele12_CaloIdL_TrackIdL_IsoVL_v",
+            "HLT_Mu8_TrkIsoVVL_Ele23_CaloIdL_TrackIdL_IsoVL_v",
+            "AlCa_EcalPhiSym_v",
+            "AlCa_LumiPixels_Random_v",
+            "AlCa_RPCMuonNormalisation_v"
+        };
+
+        const std::vector<std::string> families = {
+            "IsoMu", "IsoTkMu", "Mu", "TkMu", "Ele", "Ele_WPTight_Gsf_", "DoubleEle", "Photon", "DoublePhoton",
+            "PFJet", "PFHT", "PFMET", "PFMETNoMu", "DiPFJetAve", "DoubleJet", "QuadPFJet", "LooseIsoPFTau", "DoubleMediumIsoPFTau"
+        };
+
+        std::uniform_int_distribution<size_t> family(0, families.size() - 1);
+        std::uniform_int_distribution<size_t> threshold(1, 60);
+        std::uniform_int_distribution<size_t> suffix(0, 3);
+        const std::vector<std::string> suffixes = {"", "_eta2p1", "_CaloIdL", "_BTagCSV_p067"};
+
+        while (names.size() < 450) {
+            std::string name = "HLT_" + families[family(generator)] + std::to_string(5 * threshold(generator)) + suffixes[suffix(generator)] + "_v";
+            if (std::find(names.begin(), names.end(), name) == names.end())
+                names.push_back(name);
+        }
+
+        std::shuffle(names.begin() + 1, names.end(), generator);
+
+        std::uniform_int_distribution<size_t> versions(1, 6);
+        for (auto& name: names) {
+            if (name.back() == 'v')
+                name += std::to_string(versions(generator) + version);
+        }
+
+        names.push_back("HLTriggerFinalPath");
+
+        return names;
+    }
+
+    /**
+     * Events of run 275000 with two menus, like a run with a menu change. Dilepton paths fire
+     * often, like in the DoubleMuon and DoubleEG datasets, and the trigger objects are attached
+     * to a few accepted and rejected paths, with realistic numbers of filter labels.
+     */
+    Sample generate_sample() {
+        const size_t N_LUMIS = 40;
+        const size_t N_EVENTS_PER_LUMI = 25;
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> uniform(0, 1);
+
+        Sample sample;
+        std::vector<std::vector<int>> menu_prescales;
+        for (size_t menu = 0; menu < 2; menu++) {
+            sample.menus.emplace_back(generate_menu(menu, generator), edm::ParameterSetID(menu + 1));
+
+            const std::vector<int> values = {1, 1, 1, 1, 1, 1, 2, 5, 10, 100, 1000};
+            std::uniform_int_distribution<size_t> value(0, values.size() - 1);
+
+            std::vector<int> prescales(sample.menus.back().size());
+            for (auto& prescale: prescales)
+                prescale = values[value(generator)];
+            menu_prescales.push_back(prescales);
+        }
+
+        std::vector<std::string> filter_labels;
+        for (size_t i = 0; i < 40; i++)
+            filter_labels.push_back("hltL3fL1sMu" + std::to_string(i) + "L1f0L2f10QL3Filtered" + std::to_string(5 * i) + "Q");
+
+        const std::vector<int> pdg_ids = {13, -13, 11, -11, 22, 0, 0, 15};
+        std::uniform_int_distribution<size_t> pdg_id(0, pdg_ids.size() - 1);
+        std::uniform_int_distribution<size_t> n_objects(5, 40);
+        std::uniform_int_distribution<size_t> label(0, filter_labels.size() - 1);
+        std::uniform_int_distribution<size_t> n_labels(1, 4);
+        std::uniform_int_distribution<size_t> n_paths(0, 4);
+        std::exponential_distribution<float> pt(0.05);
+        std::uniform_real_distribution<float> eta(-2.5, 2.5);
+        std::uniform_real_distribution<float> phi(-M_PI, M_PI);
+
+        edm::EventNumber_t number = 100000000;
+        for (size_t lumi = 1; lumi <= N_LUMIS; lumi++) {
+            size_t menu = lumi <= N_LUMIS / 2 ? 0 : 1;
+            const auto& names = sample.menus[menu].triggerNames();
+            std::uniform_int_distribution<size_t> path(0, names.size() - 1);
+
+            for (size_t e = 0; e < N_EVENTS_PER_LUMI; e++) {
+                RecordedEvent event;
+                event.id = edm::EventID(275000, lumi, number += 1 + generator() % 1000);
+                event.menu = menu;
+                event.has_prescales = true;
+                event.prescales = pat::PackedTriggerPrescales(menu_prescales[menu]);
+
+                std::vector<bool> results(names.size());
+                std::vector<uint16_t> accepted;
+                for (size_t i = 0; i < names.size(); i++) {
+                    bool dilepton = names[i].find("TrkIsoVVL") != std::string::npos;
+                    results[i] = uniform(generator) < (dilepton ? 0.5 : 0.02);
+                    if (results[i])
+                        accepted.push_back(i);
+                }
+                event.results = edm::TriggerResults(results);
+
+                for (size_t o = n_objects(generator); o > 0; o--) {
+                    std::vector<uint16_t> indices;
+                    for (size_t p = accepted.empty() ? 0 : n_paths(generator); p > 0; p--)
+                        indices.push_back(accepted[generator() % accepted.size()]);
+                    for (size_t p = n_paths(generator) / 2; p > 0; p--)
+                        indices.push_back(path(generator));
+
+                    std::vector<std::string> labels;
+                    for (size_t l = n_labels(generator); l > 0; l--)
+                        labels.push_back(filter_labels[label(generator)]);
+
+                    float object_pt = 5 + pt(generator);
+                    float object_eta = eta(generator);
+                    event.objects.emplace_back(object_pt, object_eta, phi(generator), object_pt * std::cosh(object_eta), pdg_ids[pdg_id(generator)], indices, labels);
+                }
+
+                sample.events.push_back(std::move(event));
+            }
+        }
+
+        return sample;
+    }
+
+    /**
+     * An hlt producer, and the events it processes in a loop
+     */
+    class Replay {
+        public:
+            Replay(const Sample& sample, bool select_paths):
+                m_sample(sample), m_tree(m_wrapper.group("hlt_")) {
+
+                edm::ParameterSet config;
+                if (select_paths)
+                    config.addUntrackedParameter("triggers", edm::FileInPath(DATA_DIR + "/triggers.xml"));
+
+                // The producer prints the path selection
+                std::streambuf* cout = std::cout.rdbuf(nullptr);
+                m_producer.reset(new HLTProducer("hlt", m_tree, config));
+                std::cout.rdbuf(cout);
+
+                m_producer->doConsumes(config, edm::ConsumesCollector());
+            }
+
+            void process(Products products) {
+                const RecordedEvent& recorded = m_sample.events[m_position];
+                m_position = (m_position + 1) % m_sample.events.size();
+
+                if (recorded.id.run() != m_lumi.first || recorded.id.luminosityBlock() != m_lumi.second) {
+                    m_lumi = {recorded.id.run(), recorded.id.luminosityBlock()};
+                    m_producer->beginLuminosityBlock(edm::LuminosityBlock(m_lumi.first, m_lumi.second), m_setup);
+                }
+
+                edm::Event event(recorded.id, &m_sample.menus[recorded.menu]);
+                event.put(&recorded.results);
+                if (products >= Products::PRESCALES && recorded.has_prescales)
+                    event.put(&recorded.prescales);
+                if (products >= Products::OBJECTS)
+                    event.put(&recorded.objects);
+
+                m_producer->produce(event, m_setup);
+                m_wrapper.fillBranches();
+            }
+
+        private:
+            const Sample& m_sample;
+            size_t m_position = 0;
+            std::pair<edm::RunNumber_t, edm::LuminosityBlockNumber_t> m_lumi;
+
+            ROOT::TreeWrapper m_wrapper;
+            ROOT::TreeGroup m_tree;
+            edm::EventSetup m_setup;
+            std::unique_ptr<HLTProducer> m_producer;
+    };
+
+    const std::vector<std::pair<std::string, bool>> SELECTIONS = {{"all paths", false}, {"triggers.xml", true}};
+    const std::vector<std::pair<std::string, Products>> PRODUCTS = {
+        {"paths", Products::PATHS},
+        {"paths+prescales", Products::PRESCALES},
+        {"paths+prescales+objects", Products::OBJECTS}
+    };
+
+    std::string benchmark_name(const std::string& selection, const std::string& products) {
+        return "HLTProducer::produce/" + selection + "/" + products;
+    }
+
+    void register_replays(benchmark::Registry& registry, const Sample& sample) {
+        for (const auto& selection: SELECTIONS) {
+            for (const auto& products: PRODUCTS) {
+                Products level = products.second;
+                bool select_paths = selection.second;
+
+                // Warm up: build the menus of the producer
+                std::shared_ptr<Replay> replay = std::make_shared<Replay>(sample, select_paths);
+                for (size_t i = 0; i < sample.events.size(); i++)
+                    replay->process(level);
+
+                registry.add(benchmark_name(selection.first, products.first), [replay, level](benchmark::State& state) {
+                        for (size_t i = 0; i < state.iterations(); i++)
+                            replay->process(level);
+                    });
+            }
+        }
+    }
+
+    /**
+     * Cost of each step of the producer, by difference between the benchmarks with more and more products
+     */
+    void print_split(const std::map<std::string, benchmark::Result>& results) {
+        bool header = false;
+        for (const auto& selection: SELECTIONS) {
+            std::vector<double> times;
+            for (const auto& products: PRODUCTS) {
+                auto it = results.find(benchmark_name(selection.first, products.first));
+                if (it != results.end())
+                    times.push_back(it->second.ns_per_lookup);
+            }
+
+            if (times.size() != PRODUCTS.size())
+                continue;
+
+            if (! header) {
+                std::cout << std::endl << std::left << std::setw(16) << "ns/event" << std::right << std::setw(18) << "path filtering"
+                    << std::setw(18) << "prescale lookup" << std::setw(18) << "object filtering" << std::setw(10) << "total" << std::endl;
+                header = true;
+            }
+
+            std::cout << std::left << std::setw(16) << selection.first << std::right << std::fixed << std::setprecision(1)
+                << std::setw(18) << times[0] << std::setw(18) << times[1] - times[0] << std::setw(18) << times[2] - times[1]
+                << std::setw(10) << times[2] << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    benchmark::Options options;
+    std::string events_file = EVENTS_FILE;
+    bool explicit_events_file = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string value;
+        if (benchmark::parse_option(argv[i], "events", value)) {
+            events_file = value;
+            explicit_events_file = true;
+        } else if (! options.parse(argv[i])) {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--events=FILE] " << benchmark::Options::usage() << std::endl;
+            return 1;
+        }
+    }
+
+    Sample sample;
+    if (explicit_events_file || std::ifstream(events_file).good()) {
+        sample = read_sample(events_file);
+        std::cout << "Replaying " << sample.events.size() << " events from " << events_file << std::endl;
+    } else {
+        sample = generate_sample();
+        std::cout << events_file << " not found (see test/dump_hlt_events.py), using " << sample.events.size() << " synthetic events" << std::endl;
+    }
+    std::cout << std::endl;
+
+    benchmark::Registry registry;
+    register_replays(registry, sample);
+
+    auto results = benchmark::run(registry, options, "event");
+    print_split(results);
+
+    return 0;
+}
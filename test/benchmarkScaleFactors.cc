@@ -0,0 +1,335 @@
+/**
+ * Microbenchmarks of the scale-factors lookups, with realistic inputs: falling pt spectrum, flat eta and
+ * flavor-dependent b-tagging discriminator shapes, evaluated on the files of data/ScaleFactors.
+ *
+ * The code is built as in CMSSW, against the stand-ins of test/standin, so that BTaggingScaleFactors is
+ * measured as used by the jets producer.
+ *
+ * Each benchmark reports the time and the number of heap allocations per lookup. See test/benchmark.h
+ * for the options.
+ */
+
+#include "benchmark.h"
+
+#include <cp3_llbb/Framework/interface/BTaggingScaleFactors.h>
+#include <cp3_llbb/Framework/interface/BinnedValues.h>
+#include <cp3_llbb/Framework/interface/BinnedValuesJSONParser.h>
+#include <cp3_llbb/Framework/interface/Histogram.h>
+#include <cp3_llbb/Framework/interface/WeightedBinnedValues.h>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const std::string DATA_DIR = SCALEFACTORS_DATA_DIR;
+
+    // Number of distinct inputs of each benchmark, cycled through by the iterations
+    const std::size_t N_INPUTS = 1 << 14;
+
+    // Integrated luminosities of the 2016 muon scale-factors eras, in fb^-1
+    const double LUMI_BCDEF = 19.7;
+    const double LUMI_GH = 16.1;
+
+    BinnedValues load(const std::string& file) {
+        BinnedValuesJSONParser parser(DATA_DIR + "/" + file);
+        return std::move(parser.get_values());
+    }
+
+    /**
+     * Histogram with the binning of a scale-factors file. Its content is irrelevant for the bin search.
+     */
+    std::unique_ptr<Histogram<float, float>> load_binning(const std::string& file, std::size_t dimension) {
+        boost::property_tree::ptree ptree;
+        boost::property_tree::read_json(DATA_DIR + "/" + file, ptree);
+
+        std::vector<std::vector<float>> binning;
+        for (const std::string axis: {"x", "y", "z"}) {
+            if (binning.size() == dimension)
+                break;
+
+            std::vector<float> edges;
+            for (const auto& edge: ptree.get_child("binning." + axis))
+                edges.push_back(edge.second.get_value<float>());
+            binning.push_back(edges);
+        }
+
+        switch (dimension) {
+            case 1:
+                return std::unique_ptr<Histogram<float, float>>(new OneDimensionHistogram<float>(binning[0]));
+            case 2:
+                return std::unique_ptr<Histogram<float, float>>(new TwoDimensionsHistogram<float>(binning[0], binning[1]));
+            default:
+                return std::unique_ptr<Histogram<float, float>>(new ThreeDimensionsHistogram<float>(binning[0], binning[1], binning[2]));
+        }
+    }
+
+    /**
+     * Objects of a typical analysis. The pt spectrum falls like pt^-4 above a threshold, eta is flat
+     * within the acceptance, and the b-tagging discriminator peaks near 0 for light jets and near 1 for
+     * b jets, with c jets in between. About 1% of the jets have no discriminator (value of -10), like
+     * in MiniAOD.
+     */
+    struct Object {
+        Parameters parameters;
+        int hadron_flavor;
+    };
+
+    std::vector<Object> generate_objects(std::size_t n, float pt_min, float eta_max) {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> uniform(0, 1);
+        std::uniform_real_distribution<float> eta(-eta_max, eta_max);
+        std::exponential_distribution<float> light_discri(8);
+        std::exponential_distribution<float> c_discri(3);
+        std::exponential_distribution<float> b_discri(6);
+
+        std::vector<Object> objects;
+        objects.reserve(n);
+        for (std::size_t i = 0; i < n; i++) {
+            float pt = pt_min * std::pow(1 - uniform(generator), -1. / 3);
+
+            float u = uniform(generator);
+            int hadron_flavor = u < 0.15 ? 5 : (u < 0.25 ? 4 : 0);
+
+            float discri;
+            if (uniform(generator) < 0.01)
+                discri = -10;
+            else if (hadron_flavor == 5)
+                discri = 1 - std::min(b_discri(generator), 1.f);
+            else if (hadron_flavor == 4)
+                discri = std::min(c_discri(generator), 1.f);
+            else
+                discri = std::min(light_discri(generator), 1.f);
+
+            RandomKey key;
+            key.run = 1;
+            key.event = i / 4;
+            key.object = i % 4;
+
+            Parameters parameters {{BinningVariable::Pt, pt}, {BinningVariable::Eta, eta(generator)}, {BinningVariable::BTagDiscri, discri}};
+            parameters.setRandomKey(key);
+
+            objects.push_back({parameters, hadron_flavor});
+        }
+
+        return objects;
+    }
+
+    /**
+     * Values of the binning variables of @p objects, in the order of the binning of @p file
+     */
+    std::vector<std::vector<float>> binning_variables(const std::vector<Object>& objects, const std::string& file) {
+        boost::property_tree::ptree ptree;
+        boost::property_tree::read_json(DATA_DIR + "/" + file, ptree);
+
+        std::vector<BinningVariable> variables;
+        for (const auto& variable: ptree.get_child("variables"))
+            variables.push_back(BinnedValues::variable_to_string_mapping.right.at(variable.second.get_value<std::string>()));
+
+        std::vector<std::vector<float>> result;
+        for (const auto& object: objects)
+            result.push_back(object.parameters.toArray(variables));
+
+        return result;
+    }
+
+    void register_histograms(benchmark::Registry& registry) {
+        struct Case {
+            std::string name;
+            std::string file;
+            std::size_t dimension;
+        };
+
+        for (const auto& c: std::vector<Case>({
+                    {"1D/muon tracking", "Muon_tracking_BCDEFGH.json", 1},
+                    {"2D/electron id", "Electron_EGamma_SF2D_medium_moriond17.json", 2},
+                    {"3D/b-tagging", "BTagging_medium_bjets_comb_CSVv2_BtoH_moriond17.json", 3}})) {
+
+            std::shared_ptr<Histogram<float, float>> h = load_binning(c.file, c.dimension);
+            auto inputs = std::make_shared<std::vector<std::vector<float>>>(binning_variables(generate_objects(N_INPUTS, 20, 2.5), c.file));
+
+            registry.add("Histogram::findClosestBin/" + c.name, [h, inputs](benchmark::State& state) {
+                    for (std::size_t i = 0; i < state.iterations(); i++) {
+                        bool outOfRange;
+                        benchmark::DoNotOptimize(h->findClosestBin((*inputs)[i % N_INPUTS], &outOfRange));
+                    }
+                });
+        }
+    }
+
+    void register_parameters(benchmark::Registry& registry) {
+        auto objects = std::make_shared<std::vector<Object>>(generate_objects(N_INPUTS, 20, 2.5));
+        auto variables = std::make_shared<std::vector<BinningVariable>>(std::vector<BinningVariable>({BinningVariable::AbsEta, BinningVariable::Pt, BinningVariable::BTagDiscri}));
+
+        registry.add("Parameters::toArray/new vector", [objects, variables](benchmark::State& state) {
+                for (std::size_t i = 0; i < state.iterations(); i++)
+                    benchmark::DoNotOptimize((*objects)[i % N_INPUTS].parameters.toArray(*variables));
+            });
+
+        registry.add("Parameters::toArray/reused vector", [objects, variables](benchmark::State& state) {
+                std::vector<float> values;
+                for (std::size_t i = 0; i < state.iterations(); i++) {
+                    (*objects)[i % N_INPUTS].parameters.toArray(*variables, values);
+                    benchmark::DoNotOptimize(values);
+                }
+            });
+    }
+
+    void register_values(benchmark::Registry& registry, const std::string& name, std::shared_ptr<const BinnedValues> values, float pt_min, float eta_max) {
+        auto objects = std::make_shared<std::vector<Object>>(generate_objects(N_INPUTS, pt_min, eta_max));
+
+        registry.add(name, [values, objects](benchmark::State& state) {
+                for (std::size_t i = 0; i < state.iterations(); i++)
+                    benchmark::DoNotOptimize(values->get((*objects)[i % N_INPUTS].parameters));
+            });
+    }
+
+    void register_binned_values(benchmark::Registry& registry) {
+        register_values(registry, "BinnedValues::get/binned/muon tracking", std::make_shared<BinnedValues>(load("Muon_tracking_BCDEFGH.json")), 20, 2.4);
+        register_values(registry, "BinnedValues::get/binned/muon id", std::make_shared<BinnedValues>(load("Muon_TightID_genTracks_id_BCDEFGH_weighted.json")), 20, 2.4);
+        register_values(registry, "BinnedValues::get/binned/electron id", std::make_shared<BinnedValues>(load("Electron_EGamma_SF2D_medium_moriond17.json")), 20, 2.5);
+        register_values(registry, "BinnedValues::get/binned/components", std::make_shared<BinnedValues>(load("scalefactor_components_sample.json")), 20, 2.4);
+        register_values(registry, "BinnedValues::get/interpolated", std::make_shared<BinnedValues>(load("scalefactor_interpolated_sample.json")), 20, 2.4);
+        register_values(registry, "BinnedValues::get/formula/b-tagging bjets", std::make_shared<BinnedValues>(load("BTagging_medium_bjets_comb_CSVv2_BtoH_moriond17.json")), 30, 2.4);
+        register_values(registry, "BinnedValues::get/formula/b-tagging lightjets", std::make_shared<BinnedValues>(load("BTagging_medium_lightjets_incl_CSVv2_BtoH_moriond17.json")), 30, 2.4);
+    }
+
+    void register_weighted_values(benchmark::Registry& registry) {
+        std::vector<WeightedBinnedValues::part_type> parts = {
+            {DATA_DIR + "/Muon_TightID_genTracks_id_BCDEF.json", LUMI_BCDEF},
+            {DATA_DIR + "/Muon_TightID_genTracks_id_GH.json", LUMI_GH}
+        };
+
+        register_values(registry, "WeightedBinnedValues::get/muon id", std::make_shared<WeightedBinnedValues>(parts), 20, 2.4);
+
+        CombinedBinnedValues combined(parts);
+        register_values(registry, "CombinedBinnedValues/muon id", std::make_shared<BinnedValues>(std::move(combined.get_values())), 20, 2.4);
+    }
+
+    edm::ParameterSet files_set(const std::string& flavor, const std::string& file) {
+        edm::ParameterSet set;
+        set.addUntrackedParameter<std::string>("flavor", flavor);
+        set.addUntrackedParameter("file", edm::FileInPath(DATA_DIR + "/" + file));
+
+        return set;
+    }
+
+    /**
+     * Configuration of the CSVv2 working points of python/JetsProducer.py. With @p event_weights,
+     * the scale-factors files stand in for the b-tagging efficiency maps: only the values differ.
+     */
+    edm::ParameterSet btagging_configuration(bool event_weights, bool deferred) {
+        const std::vector<std::pair<std::string, double>> working_points = {{"loose", 0.5426}, {"medium", 0.8484}, {"tight", 0.9535}};
+
+        edm::ParameterSet scale_factors;
+        for (const auto& wp: working_points) {
+            std::vector<edm::ParameterSet> files = {
+                files_set("bjets", "BTagging_" + wp.first + "_bjets_comb_CSVv2_BtoH_moriond17.json"),
+                files_set("cjets", "BTagging_" + wp.first + "_cjets_comb_CSVv2_BtoH_moriond17.json"),
+                files_set("lightjets", "BTagging_" + wp.first + "_lightjets_incl_CSVv2_BtoH_moriond17.json")
+            };
+
+            edm::ParameterSet wp_set;
+            wp_set.addUntrackedParameter<std::string>("algorithm", "csvv2");
+            wp_set.addUntrackedParameter<std::string>("working_point", wp.first);
+            wp_set.addUntrackedParameter("files", files);
+
+            if (event_weights) {
+                edm::ParameterSet event_weight;
+                event_weight.addUntrackedParameter("discriminator_cut", wp.second);
+                event_weight.addUntrackedParameter("efficiencies", files);
+                wp_set.addUntrackedParameter("event_weight", event_weight);
+            }
+
+            scale_factors.addUntrackedParameter("csvv2_" + wp.first, wp_set);
+        }
+
+        edm::ParameterSet config;
+        config.addUntrackedParameter("deferred_scale_factors", deferred);
+        config.addUntrackedParameter("scale_factors", scale_factors);
+
+        return config;
+    }
+
+    /**
+     * BTaggingScaleFactors with the CSVv2 working points of python/JetsProducer.py, called like the
+     * jets producer does: one store_scale_factors per jet, then store_event_weights, and
+     * evaluate_scale_factors in deferred mode, before the branches are filled.
+     */
+    void register_btagging(benchmark::Registry& registry) {
+        struct Case {
+            std::string name;
+            bool event_weights;
+            bool deferred;
+        };
+
+        auto jets = std::make_shared<std::vector<Object>>(generate_objects(N_INPUTS, 30, 2.4));
+
+        for (const auto& c: std::vector<Case>({
+                    {"CSVv2", false, false},
+                    {"CSVv2 with event weights", true, false},
+                    {"CSVv2 with event weights, deferred", true, true}})) {
+
+            struct Producer {
+                ROOT::TreeWrapper wrapper;
+                ROOT::TreeGroup tree {wrapper.group("jet_")};
+                BTaggingScaleFactors scale_factors {tree};
+            };
+
+            // The producer prints the registered scale-factors
+            auto producer = std::make_shared<Producer>();
+            std::streambuf* cout = std::cout.rdbuf(nullptr);
+            producer->scale_factors.create_branches(btagging_configuration(c.event_weights, c.deferred));
+            std::cout.rdbuf(cout);
+
+            registry.add("BTaggingScaleFactors::store_scale_factors/" + c.name, [producer, jets](benchmark::State& state) {
+                    // Typical jet multiplicity of a ttbar event
+                    const std::size_t JETS_PER_EVENT = 6;
+
+                    BTaggingScaleFactors& scale_factors = producer->scale_factors;
+                    for (std::size_t i = 0; i < state.iterations(); i++) {
+                        const Object& jet = (*jets)[i % N_INPUTS];
+                        scale_factors.store_scale_factors(Algorithm::CSVv2, BTaggingScaleFactors::get_flavor(jet.hadron_flavor), jet.parameters, false);
+
+                        if (i % JETS_PER_EVENT == JETS_PER_EVENT - 1) {
+                            scale_factors.store_event_weights();
+                            scale_factors.evaluate_scale_factors();
+                            producer->wrapper.fillBranches();
+                        }
+                    }
+
+                    // Three working points
+                    state.SetLookupsPerIteration(3);
+                });
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    benchmark::Options options;
+    for (int i = 1; i < argc; i++) {
+        if (! options.parse(argv[i])) {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            std::cerr << "Usage: " << argv[0] << " " << benchmark::Options::usage() << std::endl;
+            return 1;
+        }
+    }
+
+    benchmark::Registry registry;
+    register_histograms(registry);
+    register_parameters(registry);
+    register_binned_values(registry);
+    register_weighted_values(registry);
+    register_btagging(registry);
+
+    benchmark::run(registry, options, "lookup");
+
+    return 0;
+}
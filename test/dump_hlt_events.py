@@ -0,0 +1,23 @@
+#! /usr/bin/env cmsRun
+
+# Record the trigger products of the data unit-test input in test/hlt_events.txt, replayed by
+# the standalone HLT benchmark (test/benchmarkHLT.cc). Run test/download_dependencies.sh first.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("DUMP")
+
+process.source = cms.Source("PoolSource",
+        fileNames = cms.untracked.vstring('file://DoubleMuon_Run2016B_PromptReco-v2_reduced.root')
+        )
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(-1))
+
+process.dumper = cms.EDAnalyzer("HLTEventsDumper",
+        output = cms.untracked.string('hlt_events.txt'),
+        hlt = cms.untracked.InputTag('TriggerResults', '', 'HLT'),
+        prescales = cms.untracked.InputTag('patTrigger'),
+        objects = cms.untracked.InputTag('selectedPatTrigger')
+        )
+
+process.p = cms.Path(process.dumper)
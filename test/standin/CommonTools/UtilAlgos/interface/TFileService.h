@@ -0,0 +1,22 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Stand-in: objects are created in memory, and are never written
+ */
+class TFileService {
+    public:
+        template <typename T, typename... Args>
+        T* make(Args&&... args) {
+            auto object = std::make_shared<T>(std::forward<Args>(args)...);
+            m_objects.push_back(object);
+
+            return object.get();
+        }
+
+    private:
+        std::vector<std::shared_ptr<void>> m_objects;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+// Stand-in: every object passes the cut
+template <typename T, bool Lazy = false>
+class StringCutObjectSelector {
+    public:
+        StringCutObjectSelector(const std::string&) {
+            // Empty
+        }
+
+        bool operator()(const T&) const {
+            return true;
+        }
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace edm {
+    template <typename T>
+    class Handle {
+        public:
+            Handle() = default;
+            explicit Handle(const T* product):
+                m_product(product) {
+                    // Empty
+                }
+
+            bool isValid() const {
+                return m_product != nullptr;
+            }
+
+            const T* product() const {
+                return m_product;
+            }
+
+            const T* operator->() const {
+                return m_product;
+            }
+
+            const T& operator*() const {
+                return *m_product;
+            }
+
+        private:
+            const T* m_product = nullptr;
+    };
+}
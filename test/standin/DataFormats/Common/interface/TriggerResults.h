@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+namespace edm {
+    class TriggerResults {
+        public:
+            TriggerResults() = default;
+            TriggerResults(const std::vector<bool>& accept):
+                m_accept(accept) {
+                    // Empty
+                }
+
+            bool accept(unsigned int index) const {
+                return m_accept[index];
+            }
+
+            unsigned int size() const {
+                return m_accept.size();
+            }
+
+        private:
+            std::vector<bool> m_accept;
+    };
+}
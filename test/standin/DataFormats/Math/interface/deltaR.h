@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cmath>
+
+namespace reco {
+    template <typename T>
+    T deltaPhi(T phi1, T phi2) {
+        T result = phi1 - phi2;
+        while (result > T(M_PI))
+            result -= T(2 * M_PI);
+        while (result <= -T(M_PI))
+            result += T(2 * M_PI);
+
+        return result;
+    }
+
+    template <typename T1, typename T2, typename T3, typename T4>
+    auto deltaR2(T1 eta1, T2 phi1, T3 eta2, T4 phi2) -> decltype(eta1 * phi1 * eta2 * phi2) {
+        auto deta = eta1 - eta2;
+        auto dphi = deltaPhi<decltype(eta1 * phi1 * eta2 * phi2)>(phi1, phi2);
+
+        return deta * deta + dphi * dphi;
+    }
+}
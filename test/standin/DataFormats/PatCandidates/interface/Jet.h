@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cmath>
+
+namespace pat {
+    // Stand-in: only the quantities of the jet id, for src/Tools.cc
+    class Jet {
+        public:
+            double eta() const {
+                return m_eta;
+            }
+
+            float neutralHadronEnergyFraction() const {
+                return 0;
+            }
+
+            float neutralEmEnergyFraction() const {
+                return 0;
+            }
+
+            float chargedHadronEnergyFraction() const {
+                return 0;
+            }
+
+            float muonEnergyFraction() const {
+                return 0;
+            }
+
+            float chargedEmEnergyFraction() const {
+                return 0;
+            }
+
+            int chargedMultiplicity() const {
+                return 0;
+            }
+
+            int neutralMultiplicity() const {
+                return 0;
+            }
+
+        private:
+            double m_eta = 0;
+    };
+}
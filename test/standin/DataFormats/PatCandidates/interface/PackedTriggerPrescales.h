@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+namespace pat {
+    class PackedTriggerPrescales {
+        public:
+            PackedTriggerPrescales() = default;
+            PackedTriggerPrescales(const std::vector<int>& prescales):
+                m_prescales(prescales) {
+                    // Empty
+                }
+
+            int getPrescaleForIndex(int index) const {
+                return m_prescales.at(index);
+            }
+
+        private:
+            std::vector<int> m_prescales;
+    };
+}
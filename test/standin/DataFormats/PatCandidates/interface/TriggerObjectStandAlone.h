@@ -0,0 +1,73 @@
+#pragma once
+
+#include <FWCore/Common/interface/TriggerNames.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pat {
+    /**
+     * Stand-in: like in MiniAOD, paths are stored as trigger indices, and are only available by
+     * name once unpacked with the names of the menu.
+     */
+    class TriggerObjectStandAlone {
+        public:
+            TriggerObjectStandAlone() = default;
+            TriggerObjectStandAlone(double pt, double eta, double phi, double energy, int pdg_id, const std::vector<uint16_t>& path_indices, const std::vector<std::string>& filter_labels):
+                m_pt(pt), m_eta(eta), m_phi(phi), m_energy(energy), m_pdg_id(pdg_id), m_path_indices(path_indices), m_filter_labels(filter_labels) {
+                    // Empty
+                }
+
+            double pt() const {
+                return m_pt;
+            }
+
+            double eta() const {
+                return m_eta;
+            }
+
+            double phi() const {
+                return m_phi;
+            }
+
+            double energy() const {
+                return m_energy;
+            }
+
+            int pdgId() const {
+                return m_pdg_id;
+            }
+
+            void unpackPathNames(const edm::TriggerNames& names) {
+                m_path_names.clear();
+                for (uint16_t index: m_path_indices)
+                    m_path_names.push_back(names.triggerName(index));
+            }
+
+            std::vector<std::string> pathNames(bool pathLastFilterAccepted = false, bool pathL3FilterAccepted = true) const {
+                return m_path_names;
+            }
+
+            std::vector<std::string> filterLabels() const {
+                return m_filter_labels;
+            }
+
+            const std::vector<uint16_t>& pathIndices() const {
+                return m_path_indices;
+            }
+
+        private:
+            double m_pt = 0;
+            double m_eta = 0;
+            double m_phi = 0;
+            double m_energy = 0;
+            int m_pdg_id = 0;
+
+            std::vector<uint16_t> m_path_indices;
+            std::vector<std::string> m_path_names;
+            std::vector<std::string> m_filter_labels;
+    };
+
+    typedef std::vector<TriggerObjectStandAlone> TriggerObjectStandAloneCollection;
+}
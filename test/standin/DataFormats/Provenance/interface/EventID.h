@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+
+namespace edm {
+    typedef uint32_t RunNumber_t;
+    typedef uint32_t LuminosityBlockNumber_t;
+    typedef uint64_t EventNumber_t;
+
+    class EventID {
+        public:
+            EventID() = default;
+            EventID(RunNumber_t run, LuminosityBlockNumber_t lumi, EventNumber_t event):
+                m_run(run), m_lumi(lumi), m_event(event) {
+                    // Empty
+                }
+
+            RunNumber_t run() const {
+                return m_run;
+            }
+
+            LuminosityBlockNumber_t luminosityBlock() const {
+                return m_lumi;
+            }
+
+            EventNumber_t event() const {
+                return m_event;
+            }
+
+            bool operator==(const EventID& other) const {
+                return m_run == other.m_run && m_lumi == other.m_lumi && m_event == other.m_event;
+            }
+
+            bool operator!=(const EventID& other) const {
+                return ! (*this == other);
+            }
+
+            bool operator<(const EventID& other) const {
+                return std::tie(m_run, m_lumi, m_event) < std::tie(other.m_run, other.m_lumi, other.m_event);
+            }
+
+        private:
+            RunNumber_t m_run = 0;
+            LuminosityBlockNumber_t m_lumi = 0;
+            EventNumber_t m_event = 0;
+    };
+}
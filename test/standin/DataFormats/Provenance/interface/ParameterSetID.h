@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace edm {
+    // Stand-in: a number instead of a hash of the parameter set
+    class ParameterSetID {
+        public:
+            ParameterSetID() = default;
+            explicit ParameterSetID(uint64_t id):
+                m_id(id) {
+                    // Empty
+                }
+
+            bool operator==(const ParameterSetID& other) const {
+                return m_id == other.m_id;
+            }
+
+            bool operator!=(const ParameterSetID& other) const {
+                return m_id != other.m_id;
+            }
+
+            bool operator<(const ParameterSetID& other) const {
+                return m_id < other.m_id;
+            }
+
+        private:
+            uint64_t m_id = 0;
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <DataFormats/Provenance/interface/ParameterSetID.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace edm {
+    class TriggerNames {
+        public:
+            typedef std::vector<std::string> Strings;
+
+            TriggerNames() = default;
+            TriggerNames(const Strings& names, const ParameterSetID& id):
+                m_names(names), m_id(id) {
+                    for (size_t i = 0; i < m_names.size(); i++)
+                        m_indices.emplace(m_names[i], i);
+                }
+
+            const Strings& triggerNames() const {
+                return m_names;
+            }
+
+            const std::string& triggerName(unsigned int index) const {
+                return m_names.at(index);
+            }
+
+            // size() if there is no trigger with this name
+            unsigned int triggerIndex(const std::string& name) const {
+                auto it = m_indices.find(name);
+                return it == m_indices.end() ? m_names.size() : it->second;
+            }
+
+            Strings::size_type size() const {
+                return m_names.size();
+            }
+
+            const ParameterSetID& parameterSetID() const {
+                return m_id;
+            }
+
+        private:
+            Strings m_names;
+            std::unordered_map<std::string, unsigned int> m_indices;
+            ParameterSetID m_id;
+    };
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <FWCore/Utilities/interface/EDGetToken.h>
+#include <FWCore/Utilities/interface/InputTag.h>
+
+namespace edm {
+    class ConsumesCollector {
+        public:
+            template <typename T>
+            EDGetTokenT<T> consumes(const InputTag&) {
+                return EDGetTokenT<T>();
+            }
+    };
+}
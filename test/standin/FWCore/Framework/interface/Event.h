@@ -0,0 +1,54 @@
+#pragma once
+
+#include <DataFormats/Common/interface/Handle.h>
+#include <DataFormats/Common/interface/TriggerResults.h>
+#include <DataFormats/Provenance/interface/EventID.h>
+#include <FWCore/Common/interface/TriggerNames.h>
+#include <FWCore/Utilities/interface/EDGetToken.h>
+
+#include <map>
+#include <typeindex>
+
+namespace edm {
+    /**
+     * Stand-in: products are put directly in the event, at most one of each type, and must
+     * outlive it. The trigger names are the ones of the event, whatever the TriggerResults.
+     */
+    class Event {
+        public:
+            Event(const EventID& id, const TriggerNames* trigger_names):
+                m_id(id), m_trigger_names(trigger_names) {
+                    // Empty
+                }
+
+            template <typename T>
+            void put(const T* product) {
+                m_products[std::type_index(typeid(T))] = product;
+            }
+
+            template <typename T>
+            bool getByToken(const EDGetTokenT<T>&, Handle<T>& handle) const {
+                auto it = m_products.find(std::type_index(typeid(T)));
+                handle = Handle<T>(it == m_products.end() ? nullptr : static_cast<const T*>(it->second));
+
+                return handle.isValid();
+            }
+
+            const TriggerNames& triggerNames(const TriggerResults&) const {
+                return *m_trigger_names;
+            }
+
+            const EventID& id() const {
+                return m_id;
+            }
+
+            bool isRealData() const {
+                return true;
+            }
+
+        private:
+            EventID m_id;
+            const TriggerNames* m_trigger_names;
+            std::map<std::type_index, const void*> m_products;
+    };
+}
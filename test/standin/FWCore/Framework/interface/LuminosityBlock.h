@@ -0,0 +1,48 @@
+#pragma once
+
+#include <DataFormats/Provenance/interface/EventID.h>
+
+namespace edm {
+    class LuminosityBlockID {
+        public:
+            LuminosityBlockID(RunNumber_t run, LuminosityBlockNumber_t lumi):
+                m_run(run), m_lumi(lumi) {
+                    // Empty
+                }
+
+            RunNumber_t run() const {
+                return m_run;
+            }
+
+            LuminosityBlockNumber_t luminosityBlock() const {
+                return m_lumi;
+            }
+
+        private:
+            RunNumber_t m_run;
+            LuminosityBlockNumber_t m_lumi;
+    };
+
+    class LuminosityBlock {
+        public:
+            LuminosityBlock(RunNumber_t run, LuminosityBlockNumber_t lumi):
+                m_id(run, lumi) {
+                    // Empty
+                }
+
+            const LuminosityBlockID& id() const {
+                return m_id;
+            }
+
+            RunNumber_t run() const {
+                return m_id.run();
+            }
+
+            LuminosityBlockNumber_t luminosityBlock() const {
+                return m_id.luminosityBlock();
+            }
+
+        private:
+            LuminosityBlockID m_id;
+    };
+}
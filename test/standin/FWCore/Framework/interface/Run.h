@@ -0,0 +1,20 @@
+#pragma once
+
+#include <DataFormats/Provenance/interface/EventID.h>
+
+namespace edm {
+    class Run {
+        public:
+            Run(RunNumber_t run):
+                m_run(run) {
+                    // Empty
+                }
+
+            RunNumber_t run() const {
+                return m_run;
+            }
+
+        private:
+            RunNumber_t m_run;
+    };
+}
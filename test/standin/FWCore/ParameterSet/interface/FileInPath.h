@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+namespace edm {
+    // Stand-in: paths are used as given, without looking into the CMSSW search path
+    class FileInPath {
+        public:
+            FileInPath() = default;
+            FileInPath(const std::string& path):
+                m_path(path) {
+                    // Empty
+                }
+
+            const std::string& fullPath() const {
+                return m_path;
+            }
+
+        private:
+            std::string m_path;
+    };
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <FWCore/ParameterSet/interface/FileInPath.h>
+#include <FWCore/Utilities/interface/EDMException.h>
+#include <FWCore/Utilities/interface/InputTag.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace edm {
+    /**
+     * Stand-in: a map of typed values. Tracked and untracked parameters are not distinguished.
+     */
+    class ParameterSet {
+        public:
+            template <typename T>
+            void addUntrackedParameter(const std::string& name, const T& value) {
+                m_values[name] = std::make_shared<Holder<T>>(value);
+            }
+
+            template <typename T>
+            void addParameter(const std::string& name, const T& value) {
+                addUntrackedParameter(name, value);
+            }
+
+            bool exists(const std::string& name) const {
+                return m_values.count(name) != 0;
+            }
+
+            template <typename T>
+            bool existsAs(const std::string& name, bool trackiness = true) const {
+                auto it = m_values.find(name);
+                return it != m_values.end() && dynamic_cast<const Holder<T>*>(it->second.get());
+            }
+
+            template <typename T>
+            T getUntrackedParameter(const std::string& name) const {
+                auto it = m_values.find(name);
+                if (it == m_values.end())
+                    throw Exception(errors::Configuration, "Missing parameter '" + name + "'");
+
+                auto holder = dynamic_cast<const Holder<T>*>(it->second.get());
+                if (! holder)
+                    throw Exception(errors::Configuration, "Parameter '" + name + "' has not the requested type");
+
+                return holder->value;
+            }
+
+            template <typename T>
+            T getUntrackedParameter(const std::string& name, const T& default_value) const {
+                return exists(name) ? getUntrackedParameter<T>(name) : default_value;
+            }
+
+            template <typename T>
+            T getParameter(const std::string& name) const {
+                return getUntrackedParameter<T>(name);
+            }
+
+            ParameterSet getUntrackedParameterSet(const std::string& name) const {
+                return getUntrackedParameter<ParameterSet>(name);
+            }
+
+            ParameterSet getParameterSet(const std::string& name) const {
+                return getUntrackedParameter<ParameterSet>(name);
+            }
+
+            std::vector<std::string> getParameterNames() const {
+                std::vector<std::string> names;
+                for (const auto& value: m_values)
+                    names.push_back(value.first);
+
+                return names;
+            }
+
+        private:
+            struct HolderBase {
+                virtual ~HolderBase() = default;
+            };
+
+            template <typename T>
+            struct Holder: public HolderBase {
+                Holder(const T& value):
+                    value(value) {
+                        // Empty
+                    }
+
+                T value;
+            };
+
+            std::map<std::string, std::shared_ptr<HolderBase>> m_values;
+    };
+}
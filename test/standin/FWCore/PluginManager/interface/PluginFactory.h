@@ -0,0 +1,8 @@
+#pragma once
+
+// Stand-in: plugins are not used outside CMSSW, only the factory typedefs must compile
+
+namespace edmplugin {
+    template <typename T>
+    class PluginFactory;
+}
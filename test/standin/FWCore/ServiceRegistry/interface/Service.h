@@ -0,0 +1,13 @@
+#pragma once
+
+namespace edm {
+    // Stand-in: one instance of each service for the whole process
+    template <typename T>
+    class Service {
+        public:
+            T* operator->() const {
+                static T s_instance;
+                return &s_instance;
+            }
+    };
+}
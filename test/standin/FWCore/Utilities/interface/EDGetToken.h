@@ -0,0 +1,8 @@
+#pragma once
+
+namespace edm {
+    // Stand-in: the event holds a single product of each type, so tokens carry no information
+    template <typename T>
+    class EDGetTokenT {
+    };
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace edm {
+    namespace errors {
+        enum ErrorCodes {
+            Configuration,
+            LogicError,
+            NotFound,
+            ProductNotFound,
+            FileReadError
+        };
+    }
+
+    class Exception: public std::runtime_error {
+        public:
+            Exception(errors::ErrorCodes category, const std::string& message):
+                std::runtime_error(message), m_category(category) {
+                    // Empty
+                }
+
+            errors::ErrorCodes categoryCode() const {
+                return m_category;
+            }
+
+        private:
+            errors::ErrorCodes m_category;
+    };
+}
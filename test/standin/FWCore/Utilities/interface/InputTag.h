@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+namespace edm {
+    class InputTag {
+        public:
+            InputTag() = default;
+            InputTag(const std::string& label, const std::string& instance = "", const std::string& process = ""):
+                m_label(label), m_instance(instance), m_process(process) {
+                    // Empty
+                }
+
+            const std::string& label() const {
+                return m_label;
+            }
+
+            const std::string& instance() const {
+                return m_instance;
+            }
+
+            const std::string& process() const {
+                return m_process;
+            }
+
+        private:
+            std::string m_label;
+            std::string m_instance;
+            std::string m_process;
+    };
+}
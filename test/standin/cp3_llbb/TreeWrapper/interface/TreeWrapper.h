@@ -0,0 +1,111 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TTree;
+
+namespace ROOT {
+    /**
+     * Stand-in: branches are kept in memory, and filling the tree only resets them, like the
+     * real TreeWrapper does after writing them
+     */
+    class Leaf {
+        public:
+            template <typename T>
+            T& write() {
+                return get<T>();
+            }
+
+            template <typename T>
+            T& transient_write() {
+                return get<T>();
+            }
+
+            void reset() {
+                if (m_reset)
+                    m_reset();
+            }
+
+        private:
+            template <typename T>
+            static void reset_value(std::vector<T>& value) {
+                value.clear();
+            }
+
+            template <typename T>
+            static void reset_value(T& value) {
+                value = T();
+            }
+
+            template <typename T>
+            T& get() {
+                if (! m_value) {
+                    auto value = std::make_shared<T>();
+                    m_value = value;
+                    m_reset = [value]() { reset_value(*value); };
+                }
+
+                return *static_cast<T*>(m_value.get());
+            }
+
+            std::shared_ptr<void> m_value;
+            std::function<void()> m_reset;
+    };
+
+    class TreeGroup;
+
+    class TreeWrapper {
+        public:
+            TreeWrapper(TTree* tree = nullptr):
+                m_leaves(std::make_shared<std::map<std::string, Leaf>>()) {
+                    // Empty
+                }
+
+            Leaf& operator[](const std::string& name) {
+                return (*m_leaves)[name];
+            }
+
+            TreeGroup group(const std::string& prefix);
+
+            void fillBranches() {
+                reset();
+            }
+
+            void reset() {
+                for (auto& leaf: *m_leaves)
+                    leaf.second.reset();
+            }
+
+        private:
+            // Shared with the groups
+            std::shared_ptr<std::map<std::string, Leaf>> m_leaves;
+    };
+
+    class TreeGroup {
+        public:
+            TreeGroup(const TreeWrapper& wrapper, const std::string& prefix):
+                m_wrapper(wrapper), m_prefix(prefix) {
+                    // Empty
+                }
+
+            Leaf& operator[](const std::string& name) {
+                return m_wrapper[m_prefix + name];
+            }
+
+            TreeGroup group(const std::string& prefix) {
+                return TreeGroup(m_wrapper, m_prefix + prefix);
+            }
+
+        private:
+            TreeWrapper m_wrapper;
+            std::string m_prefix;
+    };
+
+    inline TreeGroup TreeWrapper::group(const std::string& prefix) {
+        return TreeGroup(*this, prefix);
+    }
+}
@@ -0,0 +1,183 @@
+/**
+ * Unit tests and benchmark of the event lists. See CMakeLists.txt at the root of the package.
+ *
+ * The benchmark is hidden by default. Run it with:
+ *
+ *   testEventList "[benchmark]"
+ */
+
+#define CATCH_CONFIG_MAIN
+#include <cp3_llbb/Framework/interface/catch.hpp>
+
+#include <cp3_llbb/Framework/interface/EventList.h>
+
+#include "TemporaryFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    std::string binary(const std::vector<EventList::Entry>& entries, uint32_t version = EventList::VERSION) {
+        EventList::Header header;
+        std::memcpy(header.magic, "CP3EVL\0\0", sizeof(header.magic));
+        header.version = version;
+        header.reserved = 0;
+        header.n_events = entries.size();
+
+        std::string content(reinterpret_cast<const char*>(&header), sizeof(header));
+        content.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(EventList::Entry));
+
+        return content;
+    }
+
+    std::vector<EventList::Entry> random_entries(size_t n, std::mt19937_64& generator) {
+        std::uniform_int_distribution<uint32_t> runs(273000, 284000);
+        std::uniform_int_distribution<uint32_t> lumis(1, 2000);
+        std::uniform_int_distribution<uint64_t> events(1, 4000000000ULL);
+
+        std::vector<EventList::Entry> entries(n);
+        for (auto& entry: entries)
+            entry = {runs(generator), lumis(generator), events(generator)};
+
+        return entries;
+    }
+}
+
+TEST_CASE("Text event lists", "[events]") {
+    TemporaryFile file(
+            "# Noisy events\n"
+            "273158:12:14552\n"
+            "\n"
+            "  273302 45 998877665544\r\n"
+            "273302,45,1\n"
+            "273158:12:14552\n"
+        );
+
+    for (bool bloom_filter: {false, true}) {
+        EventList events(file.path(), bloom_filter);
+
+        REQUIRE(events.size() == 3);
+        REQUIRE(events.contains(273158, 12, 14552));
+        REQUIRE(events.contains(273302, 45, 998877665544ULL));
+        REQUIRE(events.contains(273302, 45, 1));
+
+        REQUIRE_FALSE(events.contains(273158, 12, 14553));
+        REQUIRE_FALSE(events.contains(273158, 13, 14552));
+        REQUIRE_FALSE(events.contains(273159, 12, 14552));
+    }
+
+    SECTION("Invalid lines are reported") {
+        REQUIRE_THROWS_AS(EventList(TemporaryFile("273158:12\n").path()), const std::logic_error&);
+        REQUIRE_THROWS_AS(EventList(TemporaryFile("273158:12:14552:3\n").path()), const std::logic_error&);
+        REQUIRE_THROWS_AS(EventList(TemporaryFile("273158:12:abc\n").path()), const std::logic_error&);
+        REQUIRE_THROWS_AS(EventList(TemporaryFile("8589934592:12:14552\n").path()), const std::logic_error&);
+    }
+
+    SECTION("Missing files are reported") {
+        REQUIRE_THROWS_AS(EventList("/tmp/testEventList-missing.txt"), const std::runtime_error&);
+    }
+
+    SECTION("An empty list contains nothing") {
+        EventList events(TemporaryFile("# Nothing\n").path());
+        REQUIRE(events.size() == 0);
+        REQUIRE_FALSE(events.contains(273158, 12, 14552));
+    }
+}
+
+TEST_CASE("Binary event lists", "[events]") {
+    std::vector<EventList::Entry> entries = {{273158, 12, 14552}, {273302, 45, 998877665544ULL}};
+    TemporaryFile file(binary(entries));
+
+    EventList events(file.path());
+    REQUIRE(events.size() == 2);
+    REQUIRE(events.contains(273158, 12, 14552));
+    REQUIRE(events.contains(273302, 45, 998877665544ULL));
+    REQUIRE_FALSE(events.contains(273302, 45, 14552));
+
+    SECTION("Truncated files and other versions are rejected") {
+        std::string content = binary(entries);
+        REQUIRE_THROWS_AS(EventList(TemporaryFile(content.substr(0, content.size() - 1)).path()), const std::runtime_error&);
+        REQUIRE_THROWS_AS(EventList(TemporaryFile(binary(entries, EventList::VERSION + 1)).path()), const std::runtime_error&);
+    }
+
+    SECTION("The number of events must match the size of the file") {
+        std::string content = binary(entries);
+        EventList::Header* header = reinterpret_cast<EventList::Header*>(&content[0]);
+
+        // Rejected before trying to allocate memory for the events
+        header->n_events = std::numeric_limits<uint64_t>::max();
+        REQUIRE_THROWS_AS(EventList(TemporaryFile(content).path()), const std::runtime_error&);
+
+        header->n_events = entries.size() - 1;
+        REQUIRE_THROWS_AS(EventList(TemporaryFile(content).path()), const std::runtime_error&);
+
+        header->n_events = entries.size();
+        REQUIRE_THROWS_AS(EventList(TemporaryFile(content + '\0').path()), const std::runtime_error&);
+    }
+}
+
+TEST_CASE("Large event lists", "[events]") {
+    std::mt19937_64 generator(42);
+    auto entries = random_entries(100000, generator);
+    auto others = random_entries(100000, generator);
+
+    EventList events(entries);
+    EventList events_bloom(entries, true);
+
+    for (const auto& entry: entries) {
+        REQUIRE(events.contains(entry.run, entry.lumi, entry.event));
+        REQUIRE(events_bloom.contains(entry.run, entry.lumi, entry.event));
+    }
+
+    // The Bloom filter must not change the answers
+    size_t found = 0;
+    for (const auto& entry: others) {
+        bool contains = events.contains(entry.run, entry.lumi, entry.event);
+        REQUIRE(events_bloom.contains(entry.run, entry.lumi, entry.event) == contains);
+        found += contains;
+    }
+
+    REQUIRE(found == 0);
+}
+
+TEST_CASE("Lookup benchmark", "[.][benchmark]") {
+    const size_t N_LOOKUPS = 2000000;
+
+    std::mt19937_64 generator(42);
+    auto queries = random_entries(N_LOOKUPS, generator);
+
+    std::cout << std::left << std::setw(30) << "Events" << std::setw(14) << "Bloom filter" << std::right << std::setw(16) << "ns/lookup" << std::endl;
+
+    for (size_t n_events: {1000, 100000, 5000000}) {
+        auto entries = random_entries(n_events, generator);
+
+        // 1% of the queries are in the list, like for a veto list
+        for (size_t i = 0; i < queries.size(); i += 100)
+            queries[i] = entries[i % entries.size()];
+        std::shuffle(queries.begin(), queries.end(), generator);
+
+        for (bool bloom_filter: {false, true}) {
+            EventList events(entries, bloom_filter);
+
+            // Prevent the compiler from optimizing the lookups away
+            size_t found = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& query: queries)
+                found += events.contains(query.run, query.lumi, query.event);
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            REQUIRE(found >= queries.size() / 100);
+
+            std::cout << std::left << std::setw(30) << n_events << std::setw(14) << (bloom_filter ? "yes" : "no") << std::right << std::setw(16)
+                << std::fixed << std::setprecision(1) << elapsed.count() / queries.size() << std::endl;
+        }
+    }
+}
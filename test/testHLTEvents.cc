@@ -0,0 +1,134 @@
+/**
+ * Unit tests of the format of the trigger products replayed by benchmarkHLT. See CMakeLists.txt at
+ * the root of the package.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include <cp3_llbb/Framework/interface/catch.hpp>
+
+#include "HLTEvents.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    const std::vector<std::string> MENU = {"HLTriggerFirstPath", "HLT_IsoMu24_v2", "HLT_Mu17_TrkIsoVVL_Mu8_TrkIsoVVL_v3", "HLTriggerFinalPath"};
+
+    hlt_events::Sample read(const std::string& content) {
+        std::istringstream in(content);
+        return hlt_events::read(in, "test");
+    }
+
+    std::string write(const hlt_events::Event& event) {
+        std::ostringstream out;
+        hlt_events::Writer writer(out);
+        writer.write_menu(0, MENU);
+        writer.write_event(event);
+
+        return out.str();
+    }
+
+    hlt_events::Event event(size_t menu = 0) {
+        hlt_events::Event event;
+        event.run = 275000;
+        event.lumi = 12;
+        event.event = 4000000001ULL;
+        event.menu = menu;
+        event.accept = {true, false, true, true};
+        event.has_prescales = true;
+        event.prescales = {1, 100, 1, 1};
+
+        return event;
+    }
+}
+
+TEST_CASE("Written events are read back unchanged", "[format]") {
+    std::ostringstream out;
+    hlt_events::Writer writer(out);
+
+    hlt_events::Event with_objects = event();
+    with_objects.objects.push_back({27.123457f, -2.1f, 3.1415927f, 113.70001f, -13, {1, 2}, {"hltL3crIsoL1sMu22L1f0L2f10QL3f24QL3trkIsoFiltered0p09"}});
+    with_objects.objects.push_back({1e-3f, 0, 0, 1e-3f, 0, {}, {}});
+
+    hlt_events::Event without_prescales = event(1);
+    without_prescales.event = 4000000002ULL;
+    without_prescales.accept = {false, false};
+    without_prescales.has_prescales = false;
+    without_prescales.prescales.clear();
+
+    writer.write_menu(0, MENU);
+    writer.write_event(with_objects);
+    writer.write_menu(1, {"HLTriggerFirstPath", "HLTriggerFinalPath"});
+    writer.write_event(without_prescales);
+
+    hlt_events::Sample sample = read(out.str());
+
+    REQUIRE(sample.menus.size() == 2);
+    REQUIRE(sample.menus[0] == MENU);
+    REQUIRE(sample.menus[1].size() == 2);
+
+    REQUIRE(sample.events.size() == 2);
+    for (size_t i = 0; i < 2; i++) {
+        const auto& expected = i ? without_prescales : with_objects;
+        const auto& read = sample.events[i];
+
+        REQUIRE(read.run == expected.run);
+        REQUIRE(read.lumi == expected.lumi);
+        REQUIRE(read.event == expected.event);
+        REQUIRE(read.menu == expected.menu);
+        REQUIRE(read.accept == expected.accept);
+        REQUIRE(read.has_prescales == expected.has_prescales);
+        REQUIRE(read.prescales == expected.prescales);
+
+        REQUIRE(read.objects.size() == expected.objects.size());
+        for (size_t o = 0; o < read.objects.size(); o++) {
+            // Written with enough digits to read the same floats back
+            REQUIRE(read.objects[o].pt == expected.objects[o].pt);
+            REQUIRE(read.objects[o].eta == expected.objects[o].eta);
+            REQUIRE(read.objects[o].phi == expected.objects[o].phi);
+            REQUIRE(read.objects[o].energy == expected.objects[o].energy);
+            REQUIRE(read.objects[o].pdg_id == expected.objects[o].pdg_id);
+            REQUIRE(read.objects[o].paths == expected.objects[o].paths);
+            REQUIRE(read.objects[o].filter_labels == expected.objects[o].filter_labels);
+        }
+    }
+}
+
+TEST_CASE("Invalid events files are rejected", "[format]") {
+    const std::string valid = write(event());
+    REQUIRE(read(valid).events.size() == 1);
+
+    auto replace = [&valid](const std::string& from, const std::string& to) {
+        std::string content = valid;
+        content.replace(content.find(from), from.size(), to);
+        return content;
+    };
+
+    SECTION("Truncated file") {
+        // Without the number of trigger objects
+        REQUIRE_THROWS_AS(read(valid.substr(0, valid.size() - 2)), const std::runtime_error&);
+        REQUIRE_THROWS_AS(read(valid.substr(0, valid.find("HLT_IsoMu24"))), const std::runtime_error&);
+    }
+
+    SECTION("Unknown menu") {
+        REQUIRE_THROWS_AS(read(replace("event 275000 12 4000000001 0", "event 275000 12 4000000001 1")), const std::runtime_error&);
+    }
+
+    SECTION("Wrong number of paths") {
+        REQUIRE_THROWS_AS(read(replace("\n1011\n", "\n101\n")), const std::runtime_error&);
+        REQUIRE_THROWS_AS(read(replace("\n1011\n", "\n10x1\n")), const std::runtime_error&);
+        REQUIRE_THROWS_AS(read(replace("1 100 1 1", "1 100 1")), const std::runtime_error&);
+    }
+
+    SECTION("Trigger object of an unknown path") {
+        hlt_events::Event with_object = event();
+        with_object.objects.push_back({30, 0, 0, 30, 13, {4}, {}});
+        REQUIRE_THROWS_AS(read(write(with_object)), const std::runtime_error&);
+    }
+
+    SECTION("Unexpected line") {
+        REQUIRE_THROWS_AS(read(valid + "lumi 12\n"), const std::runtime_error&);
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * Unit tests of the trigger paths selection. See CMakeLists.txt at the root of the package.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include <cp3_llbb/Framework/interface/catch.hpp>
+
+#include <cp3_llbb/Framework/interface/HLTService.h>
+
+#include "TemporaryFile.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+    const std::string DATA_DIR = HLTSERVICE_DATA_DIR;
+
+    /**
+     * Write a triggers file with @p runs as content of the root element, removed when the object goes out of scope
+     */
+    class TriggersFile: public TemporaryFile {
+        public:
+            TriggersFile(const std::string& runs):
+                TemporaryFile("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<triggers>\n" + runs + "</triggers>\n") {
+            }
+    };
+}
+
+TEST_CASE("Path patterns", "[paths]") {
+    HLTService::PathSet paths({
+            HLTService::PathName("HLT_Mu17_TrkIsoVVL_(Tk)?Mu8_TrkIsoVVL_v.*", boost::regex_constants::icase),
+            HLTService::PathName("HLT_Ele23_Ele12_.*_v.*", boost::regex_constants::icase),
+            HLTService::PathName("HLT_(Iso)?(Tk)?Mu24_v.*", boost::regex_constants::icase),
+            HLTService::PathName("HLT_IsoMu24_v2", boost::regex_constants::icase)
+        });
+
+    SECTION("The matching pattern is reported") {
+        REQUIRE(paths.match("HLT_Mu17_TrkIsoVVL_Mu8_TrkIsoVVL_v3") == 0);
+        REQUIRE(paths.match("HLT_Mu17_TrkIsoVVL_TkMu8_TrkIsoVVL_v3") == 0);
+        REQUIRE(paths.match("HLT_Ele23_Ele12_CaloIdL_TrackIdL_IsoVL_DZ_v4") == 1);
+        REQUIRE(paths.match("HLT_TkMu24_v1") == 2);
+    }
+
+    SECTION("The first matching pattern wins") {
+        REQUIRE(paths.match("HLT_IsoMu24_v2") == 2);
+    }
+
+    SECTION("Names must match entirely, ignoring case") {
+        REQUIRE(paths.matches("hlt_isomu24_v1"));
+        REQUIRE_FALSE(paths.matches("HLT_IsoMu24"));
+        REQUIRE_FALSE(paths.matches("AlCa_HLT_IsoMu24_v1"));
+        REQUIRE(paths.match("HLT_Ele27_WPTight_Gsf_v1") == HLTService::PathSet::NO_MATCH);
+    }
+
+    SECTION("An empty set matches nothing") {
+        HLTService::PathSet empty;
+        REQUIRE_FALSE(empty.matches(""));
+        REQUIRE_FALSE(empty.matches("HLT_IsoMu24_v1"));
+    }
+}
+
+TEST_CASE("Disjoint run ranges", "[runs]") {
+    TriggersFile file(
+            "<runs from=\"0\" to=\"1\"><path>HLT_MC_.*</path></runs>\n"
+            "<runs from=\"100\" to=\"199\"><path>HLT_A_.*</path></runs>\n"
+            "<runs from=\"200\" to=\"299\"><path>HLT_B_.*</path></runs>\n"
+            "<runs from=\"400\" to=\"499\"><path>HLT_C_.*</path><path>HLT_D_.*</path></runs>\n"
+        );
+
+    HLTService service(file.path());
+
+    REQUIRE(service.getPaths(0).matches("HLT_MC_v1"));
+    REQUIRE(service.getPaths(1).matches("HLT_MC_v1"));
+    REQUIRE(service.getPaths(100).matches("HLT_A_v1"));
+    REQUIRE(service.getPaths(199).matches("HLT_A_v1"));
+    REQUIRE(service.getPaths(200).matches("HLT_B_v1"));
+    REQUIRE_FALSE(service.getPaths(200).matches("HLT_A_v1"));
+    REQUIRE(service.getPaths(450).match("HLT_D_v1") == 1);
+
+    // Going back to a previous range must not use the cached one
+    REQUIRE(service.getPaths(150).matches("HLT_A_v1"));
+
+    SECTION("Runs outside of any range are rejected") {
+        REQUIRE_THROWS_AS(service.getPaths(2), const std::logic_error&);
+        REQUIRE_THROWS_AS(service.getPaths(99), const std::logic_error&);
+        REQUIRE_THROWS_AS(service.getPaths(300), const std::logic_error&);
+        REQUIRE_THROWS_AS(service.getPaths(500), const std::logic_error&);
+    }
+}
+
+TEST_CASE("Overlapping run ranges", "[runs]") {
+    // The range starting first wins where ranges overlap
+    TriggersFile file(
+            "<runs from=\"100\" to=\"300\"><path>HLT_Wide_.*</path></runs>\n"
+            "<runs from=\"150\" to=\"200\"><path>HLT_Nested_.*</path></runs>\n"
+            "<runs from=\"250\" to=\"400\"><path>HLT_Late_.*</path></runs>\n"
+        );
+
+    HLTService service(file.path());
+
+    REQUIRE(service.getPaths(100).matches("HLT_Wide_v1"));
+    REQUIRE(service.getPaths(175).matches("HLT_Wide_v1"));
+    REQUIRE(service.getPaths(201).matches("HLT_Wide_v1"));
+    REQUIRE(service.getPaths(300).matches("HLT_Wide_v1"));
+    REQUIRE(service.getPaths(301).matches("HLT_Late_v1"));
+    REQUIRE(service.getPaths(400).matches("HLT_Late_v1"));
+
+    REQUIRE_THROWS_AS(service.getPaths(99), const std::logic_error&);
+    REQUIRE_THROWS_AS(service.getPaths(401), const std::logic_error&);
+}
+
+TEST_CASE("Default triggers file", "[runs]") {
+    HLTService service(DATA_DIR + "/triggers.xml");
+
+    REQUIRE(service.getPaths(1).matches("HLT_Mu17_TrkIsoVVL_Mu8_TrkIsoVVL_DZ_v3"));
+    REQUIRE(service.getPaths(260000).matches("HLT_Mu17_TrkIsoVVL_TkMu8_TrkIsoVVL_DZ_v1"));
+    REQUIRE_FALSE(service.getPaths(260000).matches("HLT_IsoMu20_v1"));
+    REQUIRE(service.getPaths(280000).matches("HLT_Mu17_TrkIsoVVL_TkMu8_TrkIsoVVL_v2"));
+}
@@ -0,0 +1,62 @@
+/**
+ * Unit tests of the certified luminosity mask. See CMakeLists.txt at the root of the package.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include <cp3_llbb/Framework/interface/catch.hpp>
+
+#include <cp3_llbb/Framework/interface/LumiMask.h>
+
+#include "TemporaryFile.h"
+
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("Certified luminosity blocks", "[lumis]") {
+    TemporaryFile file(R"({"273302": [[1, 459], [461, 600]], "273158": [[1, 1279]], "274968": [[1, 10], [5, 20], [21, 30], [40, 40]]})");
+
+    LumiMask mask(file.path());
+
+    REQUIRE(mask.runs() == 3);
+
+    SECTION("Interval bounds are included") {
+        REQUIRE(mask.contains(273158, 1));
+        REQUIRE(mask.contains(273158, 1279));
+        REQUIRE_FALSE(mask.contains(273158, 0));
+        REQUIRE_FALSE(mask.contains(273158, 1280));
+    }
+
+    SECTION("Gaps between intervals are rejected") {
+        REQUIRE(mask.contains(273302, 459));
+        REQUIRE_FALSE(mask.contains(273302, 460));
+        REQUIRE(mask.contains(273302, 461));
+        REQUIRE_FALSE(mask.contains(274968, 31));
+        REQUIRE_FALSE(mask.contains(274968, 39));
+        REQUIRE(mask.contains(274968, 40));
+        REQUIRE_FALSE(mask.contains(274968, 41));
+    }
+
+    SECTION("Overlapping and adjacent intervals are merged") {
+        REQUIRE(mask.intervals() == 5);
+        REQUIRE(mask.contains(274968, 15));
+        REQUIRE(mask.contains(274968, 25));
+    }
+
+    SECTION("Runs not listed are rejected") {
+        REQUIRE_FALSE(mask.contains(1, 1));
+        REQUIRE_FALSE(mask.contains(273200, 1));
+        REQUIRE_FALSE(mask.contains(300000, 1));
+    }
+}
+
+TEST_CASE("Invalid luminosity masks", "[lumis]") {
+    REQUIRE_THROWS_AS(LumiMask(TemporaryFile(R"({"run": [[1, 2]]})").path()), const std::logic_error&);
+    REQUIRE_THROWS_AS(LumiMask(TemporaryFile(R"({"1": [[2, 1]]})").path()), const std::logic_error&);
+    REQUIRE_THROWS_AS(LumiMask(TemporaryFile(R"({"1": [[1, 2, 3]]})").path()), const std::logic_error&);
+
+    SECTION("An empty mask rejects everything") {
+        LumiMask mask(TemporaryFile("{}").path());
+        REQUIRE(mask.runs() == 0);
+        REQUIRE_FALSE(mask.contains(1, 1));
+    }
+}
@@ -0,0 +1,682 @@
+/**
+ * Unit tests and benchmarks of the standalone scale-factors library. See CMakeLists.txt at the root of the package.
+ *
+ * Benchmarks are hidden by default. Run them with:
+ *
+ *   testScaleFactors "[benchmark]"
+ */
+
+#define CATCH_CONFIG_MAIN
+#include <cp3_llbb/Framework/interface/catch.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <cp3_llbb/Framework/interface/BinnedValues.h>
+#include <cp3_llbb/Framework/interface/BinnedValuesBinaryParser.h>
+#include <cp3_llbb/Framework/interface/BinnedValuesC.h>
+#include <cp3_llbb/Framework/interface/BinnedValuesJSONParser.h>
+#include <cp3_llbb/Framework/interface/WeightedBinnedValues.h>
+
+#include "TemporaryFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+namespace {
+    const std::string DATA_DIR = SCALEFACTORS_DATA_DIR;
+
+    std::vector<std::string> list_json_files() {
+        std::vector<std::string> files;
+
+        DIR* dir = opendir(DATA_DIR.c_str());
+        if (! dir)
+            throw std::runtime_error("Failed to open " + DATA_DIR);
+
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0)
+                files.push_back(DATA_DIR + "/" + name);
+        }
+        closedir(dir);
+
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    /**
+     * Scale-factors files registered in a producer configuration of python/
+     */
+    std::vector<std::string> list_configuration_files(const std::string& configuration) {
+        const std::string prefix = "cp3_llbb/Framework/data/ScaleFactors/";
+
+        std::ifstream python(DATA_DIR + "/../../python/" + configuration);
+        if (! python.is_open())
+            throw std::runtime_error("Failed to open " + configuration);
+
+        std::vector<std::string> files;
+        std::string line;
+        while (std::getline(python, line)) {
+            size_t start = line.find(prefix);
+            if (start == std::string::npos || line.find('#') < start)
+                continue;
+
+            start += prefix.size();
+            files.push_back(DATA_DIR + "/" + line.substr(start, line.find('\'', start) - start));
+        }
+
+        return files;
+    }
+
+    BinnedValues load(const std::string& file) {
+        BinnedValuesJSONParser parser(file);
+        return std::move(parser.get_values());
+    }
+
+    BinnedValues load_binary(const std::string& file) {
+        BinnedValuesBinaryParser parser(file);
+        return std::move(parser.get_values());
+    }
+
+    std::string read_file(const std::string& file) {
+        std::ifstream in(file, std::ios::binary);
+        if (! in.is_open())
+            throw std::runtime_error("Failed to open " + file);
+
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * Binary version of the JSON @p content, written by scripts/convertScaleFactorsToBinary.py.
+     * Both files are removed when the object goes out of scope.
+     */
+    class BinaryFile {
+        public:
+            BinaryFile(const std::string& content):
+                m_json(content), m_path(m_json.path() + BinnedValuesBinaryParser::EXTENSION) {
+
+                std::string command = std::string(SCALEFACTORS_CONVERTER) + " -o /tmp " + m_json.path() + " > /dev/null 2>&1";
+                if (std::system(command.c_str()) != 0)
+                    throw std::runtime_error("Failed to convert " + m_json.path());
+            }
+
+            ~BinaryFile() {
+                unlink(m_path.c_str());
+            }
+
+            const std::string& path() const {
+                return m_path;
+            }
+
+        private:
+            TemporaryFile m_json;
+            std::string m_path;
+    };
+
+    /**
+     * Centre of every bin of the JSON @p file, whose binning variables are @p variables
+     */
+    std::vector<Parameters> bin_centers(const std::string& file, const std::vector<BinningVariable>& variables) {
+        boost::property_tree::ptree ptree;
+        boost::property_tree::read_json(file, ptree);
+
+        std::vector<Parameters> centers(1);
+        for (size_t axis = 0; axis < variables.size(); axis++) {
+            std::vector<float> edges;
+            for (const auto& edge: ptree.get_child(std::string("binning.") + "xyz"[axis]))
+                edges.push_back(edge.second.get_value<float>());
+
+            std::vector<Parameters> next;
+            for (const auto& p: centers) {
+                for (size_t i = 0; i + 1 < edges.size(); i++) {
+                    Parameters center = p;
+                    center.set(variables[axis], (edges[i] + edges[i + 1]) / 2);
+                    next.push_back(center);
+                }
+            }
+
+            centers = std::move(next);
+        }
+
+        return centers;
+    }
+
+    /**
+     * Realistic inputs: falling pt spectrum, flat eta within the tracker, flat discriminator
+     */
+    std::vector<Parameters> generate_parameters(size_t n) {
+        std::mt19937 generator(42);
+        std::exponential_distribution<float> pt(1. / 40);
+        std::uniform_real_distribution<float> eta(-2.5, 2.5);
+        std::uniform_real_distribution<float> discri(0, 1);
+
+        std::vector<Parameters> parameters;
+        parameters.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            parameters.push_back({{BinningVariable::Pt, 20 + pt(generator)}, {BinningVariable::Eta, eta(generator)},
+                    {BinningVariable::BTagDiscri, discri(generator)}});
+        }
+
+        return parameters;
+    }
+}
+
+TEST_CASE("Parameters", "[parameters]") {
+    Parameters p {{BinningVariable::Eta, -1.5}, {BinningVariable::Pt, 30}};
+
+    SECTION("Setting eta also sets its absolute value") {
+        REQUIRE(p.get(BinningVariable::Eta) == Approx(-1.5));
+        REQUIRE(p.get(BinningVariable::AbsEta) == Approx(1.5));
+    }
+
+    SECTION("Setters overwrite existing values") {
+        p.setPt(50);
+        REQUIRE(p.get(BinningVariable::Pt) == Approx(50));
+    }
+
+    SECTION("Missing variables are reported") {
+        REQUIRE_THROWS_AS(p.get(BinningVariable::BTagDiscri), const std::invalid_argument&);
+    }
+}
+
+TEST_CASE("Binned lookup", "[lookup]") {
+    BinnedValues values = load(DATA_DIR + "/scalefactor_sample.json");
+
+    SECTION("Value inside the binning") {
+        auto result = values.get({{BinningVariable::Eta, 0.5}, {BinningVariable::Pt, 20}});
+        REQUIRE(result.size() == 3);
+        REQUIRE(result[Nominal] == Approx(2));
+        REQUIRE(result[Up] == Approx(1));
+        REQUIRE(result[Down] == Approx(1));
+    }
+
+    SECTION("Values outside the binning use the closest bin, with doubled errors") {
+        auto result = values.get({{BinningVariable::Eta, 0.5}, {BinningVariable::Pt, 5000}});
+        REQUIRE(result[Nominal] == Approx(3));
+        REQUIRE(result[Up] == Approx(2));
+        REQUIRE(result[Down] == Approx(2));
+    }
+}
+
+TEST_CASE("Interpolated lookup", "[lookup][interpolation]") {
+    // Bin contents are sampled at the bin centres from 1 + 0.2 * eta + 0.01 * pt + 0.001 * eta * pt,
+    // which is exactly reproduced by a bilinear interpolation
+    BinnedValues values = load(DATA_DIR + "/scalefactor_interpolated_sample.json");
+
+    auto expected = [](float eta, float pt) {
+        return 1 + 0.2 * eta + 0.01 * pt + 0.001 * eta * pt;
+    };
+
+    SECTION("Values between bin centres are interpolated") {
+        for (float eta: {0.5, 0.8, 1.0, 1.5}) {
+            for (float pt: {5, 12, 20, 30, 39}) {
+                auto result = values.get({{BinningVariable::Eta, eta}, {BinningVariable::Pt, pt}});
+                REQUIRE(result[Nominal] == Approx(expected(eta, pt)));
+                REQUIRE(result[Up] == Approx(0.1));
+                REQUIRE(result[Down] == Approx(0.1));
+            }
+        }
+    }
+
+    SECTION("Values are constant between the last bin centre and the last bin edge") {
+        auto result = values.get({{BinningVariable::Eta, 1.9}, {BinningVariable::Pt, 45}});
+        REQUIRE(result[Nominal] == Approx(expected(1.5, 40)));
+        REQUIRE(result[Up] == Approx(0.1));
+    }
+
+    SECTION("Values outside the binning use the closest bin centre, with doubled errors") {
+        auto result = values.get({{BinningVariable::Eta, 1.0}, {BinningVariable::Pt, 500}});
+        REQUIRE(result[Nominal] == Approx(expected(1.0, 40)));
+        REQUIRE(result[Up] == Approx(0.2));
+        REQUIRE(result[Down] == Approx(0.2));
+    }
+
+    SECTION("NaN values use the first bin, like binned lookups") {
+        auto result = values.get({{BinningVariable::Eta, 1.0}, {BinningVariable::Pt, std::numeric_limits<float>::quiet_NaN()}});
+        REQUIRE(result[Nominal] == Approx(expected(1.0, 5)));
+        REQUIRE(result[Up] == Approx(0.2));
+        REQUIRE(result[Down] == Approx(0.2));
+    }
+}
+
+TEST_CASE("Uncertainty components", "[lookup][components]") {
+    BinnedValues values = load(DATA_DIR + "/scalefactor_components_sample.json");
+
+    REQUIRE(values.getComponents() == std::vector<std::string>({"stat", "syst"}));
+
+    SECTION("One lookup returns the total errors and every component") {
+        auto result = values.get({{BinningVariable::Eta, 1.5}, {BinningVariable::Pt, 30}});
+        REQUIRE(result.size() == 7);
+        REQUIRE(result[Nominal] == Approx(0.97));
+
+        // Relative errors are converted to absolute errors, like the total ones
+        REQUIRE(result[componentIndex(0, Down)] == Approx(0.97 * 0.015));
+        REQUIRE(result[componentIndex(0, Up)] == Approx(0.97 * 0.015));
+        REQUIRE(result[componentIndex(1, Down)] == Approx(0.97 * 0.02));
+        REQUIRE(result[componentIndex(1, Up)] == Approx(0.97 * 0.02));
+    }
+
+    SECTION("Component errors are doubled outside the binning") {
+        auto result = values.get({{BinningVariable::Eta, 3}, {BinningVariable::Pt, 30}});
+        REQUIRE(result[componentIndex(0, Down)] == Approx(2 * 0.97 * 0.015));
+        REQUIRE(result[componentIndex(1, Up)] == Approx(2 * 0.97 * 0.02));
+    }
+
+    SECTION("Unit values have the same layout") {
+        auto unit = values.getUnitValues();
+        REQUIRE(unit.size() == 7);
+        REQUIRE(unit[Nominal] == 1);
+        REQUIRE(std::count(unit.begin(), unit.end(), 0) == 6);
+    }
+}
+
+TEST_CASE("Invalid files are rejected when loaded", "[validation]") {
+    auto json = [](const std::string& binning, const std::string& data) {
+        return "{\"dimension\": 1, \"variables\": [\"Pt\"], \"binning\": {\"x\": " + binning + "}, "
+            "\"error_type\": \"absolute\", \"data\": [" + data + "]}";
+    };
+
+    auto bin = [](const std::string& low, const std::string& high, const std::string& value) {
+        return "{\"bin\": [" + low + ", " + high + "], \"value\": " + value + ", \"error_low\": 0.1, \"error_high\": 0.1}";
+    };
+
+    SECTION("Valid file") {
+        TemporaryFile file(json("[0, 10, 20]", bin("0", "10", "1") + ", " + bin("10", "20", "2")));
+        REQUIRE_NOTHROW(load(file.path()));
+    }
+
+    SECTION("Edges must be increasing") {
+        TemporaryFile file(json("[0, 20, 10]", bin("0", "20", "1") + ", " + bin("20", "10", "2")));
+        REQUIRE_THROWS_AS(load(file.path()), const std::logic_error&);
+    }
+
+    SECTION("Every bin must be filled") {
+        TemporaryFile file(json("[0, 10, 20]", bin("0", "10", "1")));
+        REQUIRE_THROWS_AS(load(file.path()), const std::logic_error&);
+    }
+
+    SECTION("Bins of the data section must be inside the binning") {
+        TemporaryFile file(json("[0, 10, 20]", bin("0", "10", "1") + ", " + bin("10", "20", "2") + ", " + bin("20", "30", "3")));
+        REQUIRE_THROWS(load(file.path()));
+    }
+}
+
+TEST_CASE("Binary files give the same results as JSON files", "[binary]") {
+    auto check = [](const std::string& name, const std::vector<BinningVariable>& variables) {
+        INFO("File: " << name);
+
+        std::string file = DATA_DIR + "/" + name;
+        BinaryFile binary(read_file(file));
+
+        BinnedValues expected = load(file);
+        BinnedValues values = load_binary(binary.path());
+
+        REQUIRE(values.hasSameBinning(expected));
+        REQUIRE(values.getComponents() == expected.getComponents());
+
+        for (const auto& p: bin_centers(file, variables))
+            REQUIRE(values.get(p) == expected.get(p));
+
+        // Between bin centres and outside the binning
+        for (const auto& p: generate_parameters(1000))
+            REQUIRE(values.get(p) == expected.get(p));
+    };
+
+    SECTION("Binned values") {
+        check("scalefactor_sample.json", {BinningVariable::AbsEta, BinningVariable::Pt});
+    }
+
+    SECTION("Interpolated values") {
+        check("scalefactor_interpolated_sample.json", {BinningVariable::AbsEta, BinningVariable::Pt});
+    }
+
+    SECTION("Uncertainty components") {
+        check("scalefactor_components_sample.json", {BinningVariable::AbsEta, BinningVariable::Pt});
+    }
+
+    SECTION("Formulas") {
+        check("BTagging_medium_bjets_comb_CSVv2_BtoH_moriond17.json", {BinningVariable::Eta, BinningVariable::Pt, BinningVariable::BTagDiscri});
+    }
+}
+
+TEST_CASE("Invalid binary files are rejected when loaded", "[binary][validation]") {
+    auto bin = [](const std::string& low, const std::string& high, const std::string& value) {
+        return "{\"bin\": [" + low + ", " + high + "], \"value\": " + value + ", \"error_low\": " + value + ", \"error_high\": " + value + "}";
+    };
+
+    auto json = [](const std::string& data, bool formula = false) {
+        return "{\"dimension\": 1, \"variables\": [\"Pt\"], \"binning\": {\"x\": [0, 10, 20]}, \"error_type\": \"absolute\", " +
+            std::string(formula ? "\"formula\": true, \"variable\": \"x\", " : "") + "\"data\": [" + data + "]}";
+    };
+
+    BinaryFile valid(json(bin("0", "10", "1") + ", " + bin("10", "20", "2")));
+    const std::string content = read_file(valid.path());
+
+    REQUIRE_NOTHROW(load_binary(valid.path()));
+
+    SECTION("Truncated file") {
+        REQUIRE_THROWS_AS(load_binary(TemporaryFile(content.substr(0, sizeof(BinnedValuesBinaryParser::Header) - 1)).path()), const std::runtime_error&);
+        REQUIRE_THROWS_AS(load_binary(TemporaryFile(content.substr(0, content.size() - 4)).path()), const std::runtime_error&);
+    }
+
+    SECTION("Wrong magic") {
+        std::string wrong = content;
+        wrong[0] = 'X';
+        REQUIRE_THROWS_AS(load_binary(TemporaryFile(wrong).path()), const std::runtime_error&);
+    }
+
+    SECTION("Unsupported version") {
+        std::string newer = content;
+        uint32_t version = BinnedValuesBinaryParser::VERSION + 1;
+        std::memcpy(&newer[offsetof(BinnedValuesBinaryParser::Header, version)], &version, sizeof(version));
+        REQUIRE_THROWS_AS(load_binary(TemporaryFile(newer).path()), const std::runtime_error&);
+    }
+
+    SECTION("Every bin must be filled") {
+        BinaryFile missing(json(bin("0", "10", "1")));
+        REQUIRE_THROWS_AS(load_binary(missing.path()), const std::logic_error&);
+    }
+
+    SECTION("Every formula must be filled") {
+        BinaryFile formula(json(bin("0", "10", "\"x\"") + ", " + bin("10", "20", "\"2 * x\""), true));
+        REQUIRE_NOTHROW(load_binary(formula.path()));
+
+        BinaryFile missing(json(bin("0", "10", "\"x\""), true));
+        REQUIRE_THROWS_AS(load_binary(missing.path()), const std::logic_error&);
+    }
+}
+
+TEST_CASE("Every scale-factors file can be loaded and evaluated", "[files]") {
+    auto files = list_json_files();
+    REQUIRE(! files.empty());
+
+    auto parameters = generate_parameters(100);
+
+    for (const auto& file: files) {
+        INFO("File: " << file);
+
+        BinnedValues values = load(file);
+
+        for (const auto& p: parameters) {
+            auto result = values.get(p);
+            REQUIRE(result.size() == 3 + 2 * values.getComponents().size());
+            REQUIRE(std::isfinite(result[Nominal]));
+            REQUIRE(std::isfinite(result[Up]));
+            REQUIRE(std::isfinite(result[Down]));
+        }
+    }
+}
+
+TEST_CASE("Lookup context gives the same results as direct lookups", "[lookup]") {
+    std::vector<BinnedValues> values;
+    for (const auto& file: list_json_files()) {
+        if (file.find("BTagging_") != std::string::npos && file.find("CSVv2_BtoH_moriond17") != std::string::npos)
+            values.push_back(load(file));
+    }
+
+    REQUIRE(! values.empty());
+
+    BinnedValuesLookupContext context;
+    std::vector<size_t> layouts;
+    for (const auto& v: values)
+        layouts.push_back(context.add_layout(v));
+
+    // Working points and flavors share a few binning layouts
+    REQUIRE(context.size() < values.size());
+
+    for (const auto& p: generate_parameters(1000)) {
+        context.set_parameters(p);
+        for (size_t i = 0; i < values.size(); i++)
+            REQUIRE(context.get(values[i], layouts[i]) == values[i].get(p));
+    }
+}
+
+TEST_CASE("Weighted values are reproducible", "[weighted]") {
+    std::string first = DATA_DIR + "/Muon_TightID_genTracks_id_BCDEF.json";
+    std::string second = DATA_DIR + "/Muon_TightID_genTracks_id_GH.json";
+
+    BinnedValues first_values = load(first);
+    BinnedValues second_values = load(second);
+
+    Parameters p {{BinningVariable::Eta, 1.2}, {BinningVariable::Pt, 45}};
+
+    SECTION("A component with a null weight is never selected") {
+        WeightedBinnedValues weighted({{first, 1}, {second, 0}});
+        for (size_t i = 0; i < 100; i++)
+            REQUIRE(weighted.get(p) == first_values.get(p));
+    }
+
+    SECTION("The same object always gets the same component") {
+        WeightedBinnedValues weighted({{first, 0.5}, {second, 0.5}});
+
+        size_t n_first = 0;
+        for (uint32_t object = 0; object < 1000; object++) {
+            RandomKey key;
+            key.run = 1;
+            key.event = 12345;
+            key.object = object;
+            p.setRandomKey(key);
+
+            auto result = weighted.get(p);
+            REQUIRE(weighted.get(p) == result);
+
+            if (result == first_values.get(p))
+                n_first++;
+            else
+                REQUIRE(result == second_values.get(p));
+        }
+
+        // Both components must be sampled
+        REQUIRE(n_first > 400);
+        REQUIRE(n_first < 600);
+    }
+}
+
+TEST_CASE("Weighted values can be combined when loaded", "[weighted]") {
+    std::string first = DATA_DIR + "/Muon_TightID_genTracks_id_BCDEF.json";
+    std::string second = DATA_DIR + "/Muon_TightID_genTracks_id_GH.json";
+
+    BinnedValues first_values = load(first);
+    BinnedValues second_values = load(second);
+
+    CombinedBinnedValues combiner({{first, 0.3}, {second, 0.2}});
+    BinnedValues combined = std::move(combiner.get_values());
+
+    for (const auto& p: generate_parameters(1000)) {
+        auto a = first_values.get(p);
+        auto b = second_values.get(p);
+        auto result = combined.get(p);
+
+        REQUIRE(result.size() == 3);
+        for (size_t i = 0; i < result.size(); i++)
+            REQUIRE(result[i] == Approx(0.6 * a[i] + 0.4 * b[i]));
+    }
+
+    SECTION("Formulas cannot be combined") {
+        std::string formula = DATA_DIR + "/BTagging_medium_bjets_comb_CSVv2_BtoH_moriond17.json";
+        REQUIRE_THROWS_AS(CombinedBinnedValues({{formula, 0.5}, {formula, 0.5}}), const std::logic_error&);
+    }
+
+    SECTION("Interpolated values are combined exactly") {
+        std::string interpolated = DATA_DIR + "/scalefactor_interpolated_sample.json";
+        BinnedValues values = load(interpolated);
+
+        CombinedBinnedValues combiner({{interpolated, 0.5}, {interpolated, 0.5}});
+        BinnedValues combined = std::move(combiner.get_values());
+
+        for (float eta: {0.5, 0.8, 1.5}) {
+            for (float pt: {5, 12, 39}) {
+                Parameters p {{BinningVariable::Eta, eta}, {BinningVariable::Pt, pt}};
+                REQUIRE(combined.get(p)[Nominal] == Approx(values.get(p)[Nominal]));
+            }
+        }
+    }
+
+    SECTION("Errors are only doubled outside the range of the common binning") {
+        auto json = [](const std::string& binning, const std::string& data) {
+            return "{\"dimension\": 1, \"variables\": [\"Pt\"], \"binning\": {\"x\": " + binning + "}, "
+                "\"error_type\": \"absolute\", \"data\": [" + data + "]}";
+        };
+
+        auto bin = [](const std::string& low, const std::string& high) {
+            return "{\"bin\": [" + low + ", " + high + "], \"value\": 1, \"error_low\": 0.1, \"error_high\": 0.1}";
+        };
+
+        TemporaryFile narrow(json("[0, 10, 20]", bin("0", "10") + ", " + bin("10", "20")));
+        TemporaryFile wide(json("[0, 10, 20, 30]", bin("0", "10") + ", " + bin("10", "20") + ", " + bin("20", "30")));
+
+        CombinedBinnedValues combiner({{narrow.path(), 0.5}, {wide.path(), 0.5}});
+        BinnedValues combined = std::move(combiner.get_values());
+
+        // Outside the range of the narrow set only
+        auto inside = combined.get({{BinningVariable::Pt, 25}});
+        REQUIRE(inside[Nominal] == Approx(1));
+        REQUIRE(inside[Up] == Approx(0.1));
+        REQUIRE(inside[Down] == Approx(0.1));
+
+        auto outside = combined.get({{BinningVariable::Pt, 50}});
+        REQUIRE(outside[Up] == Approx(0.2));
+        REQUIRE(outside[Down] == Approx(0.2));
+    }
+
+    SECTION("Interpolated values with different binnings cannot be combined") {
+        auto json = [](const std::string& binning, const std::string& data) {
+            return "{\"dimension\": 1, \"variables\": [\"Pt\"], \"binning\": {\"x\": " + binning + "}, "
+                "\"error_type\": \"absolute\", \"interpolation\": \"linear\", \"data\": [" + data + "]}";
+        };
+
+        TemporaryFile coarse(json("[0, 20]", "{\"bin\": [0, 20], \"value\": 1, \"error_low\": 0.1, \"error_high\": 0.1}"));
+        TemporaryFile fine(json("[0, 10, 20]", "{\"bin\": [0, 10], \"value\": 1, \"error_low\": 0.1, \"error_high\": 0.1}, "
+                    "{\"bin\": [10, 20], \"value\": 2, \"error_low\": 0.1, \"error_high\": 0.1}"));
+
+        REQUIRE_THROWS_AS(CombinedBinnedValues({{coarse.path(), 0.5}, {fine.path(), 0.5}}), const std::logic_error&);
+    }
+}
+
+TEST_CASE("C interface gives the same results as the framework", "[c]") {
+    std::string file = DATA_DIR + "/BTagging_medium_bjets_comb_CSVv2_BtoH_moriond17.json";
+    BinnedValues values = load(file);
+
+    char error[256];
+    BinnedValuesHandle* handle = binned_values_load(file.c_str(), error, sizeof(error));
+    REQUIRE(handle);
+
+    auto parameters = generate_parameters(1000);
+    std::vector<float> pt, eta, discri;
+    for (const auto& p: parameters) {
+        pt.push_back(p.get(BinningVariable::Pt));
+        eta.push_back(p.get(BinningVariable::Eta));
+        discri.push_back(p.get(BinningVariable::BTagDiscri));
+    }
+
+    std::vector<float> nominal(pt.size()), up(pt.size()), down(pt.size());
+    REQUIRE(binned_values_evaluate(handle, pt.size(), pt.data(), eta.data(), discri.data(), nominal.data(), up.data(), down.data(), error, sizeof(error)) == 0);
+
+    for (size_t i = 0; i < parameters.size(); i++) {
+        auto expected = values.get(parameters[i]);
+        REQUIRE(nominal[i] == expected[Nominal]);
+        REQUIRE(up[i] == expected[Up]);
+        REQUIRE(down[i] == expected[Down]);
+    }
+
+    SECTION("Missing variables are reported") {
+        REQUIRE(binned_values_evaluate(handle, pt.size(), pt.data(), nullptr, discri.data(), nominal.data(), up.data(), down.data(), error, sizeof(error)) != 0);
+        REQUIRE(std::string(error).find("Eta") != std::string::npos);
+    }
+
+    binned_values_free(handle);
+
+    REQUIRE_FALSE(binned_values_load((DATA_DIR + "/missing.json").c_str(), error, sizeof(error)));
+}
+
+TEST_CASE("Lookup benchmark", "[.][benchmark]") {
+    const size_t N_LOOKUPS = 200000;
+    auto parameters = generate_parameters(N_LOOKUPS);
+
+    size_t total_lookups = 0;
+    std::chrono::duration<double> total_time(0);
+
+    std::cout << std::left << std::setw(70) << "File" << std::right << std::setw(16) << "lookups/s" << std::endl;
+
+    for (const auto& file: list_json_files()) {
+        BinnedValues values = load(file);
+
+        // Prevent the compiler from optimizing the lookups away
+        float sum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& p: parameters)
+            sum += values.get(p)[Nominal];
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(std::isfinite(sum));
+
+        total_lookups += parameters.size();
+        total_time += elapsed;
+
+        std::cout << std::left << std::setw(70) << file.substr(DATA_DIR.size() + 1) << std::right << std::setw(16)
+            << std::fixed << std::setprecision(0) << parameters.size() / elapsed.count() << std::endl;
+    }
+
+    std::cout << std::left << std::setw(70) << "All files" << std::right << std::setw(16)
+        << std::fixed << std::setprecision(0) << total_lookups / total_time.count() << std::endl;
+}
+
+TEST_CASE("Producers benchmark", "[.][benchmark]") {
+    // Per-object cost of the scale-factors of the producers, with and without sharing the bin search
+    const size_t N_OBJECTS = 100000;
+    auto parameters = generate_parameters(N_OBJECTS);
+
+    std::cout << std::left << std::setw(30) << "Configuration" << std::right << std::setw(8) << "SFs" << std::setw(10) << "layouts"
+        << std::setw(16) << "direct ns/obj" << std::setw(16) << "shared ns/obj" << std::setw(10) << "speedup" << std::endl;
+
+    for (const char* configuration: {"MuonsProducer.py", "ElectronsProducer.py"}) {
+        std::vector<BinnedValues> values;
+        for (const auto& file: list_configuration_files(configuration))
+            values.push_back(load(file));
+
+        REQUIRE(! values.empty());
+
+        BinnedValuesLookupContext context;
+        std::vector<size_t> layouts;
+        for (const auto& v: values)
+            layouts.push_back(context.add_layout(v));
+
+        float direct_sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& p: parameters) {
+            for (const auto& v: values)
+                direct_sum += v.get(p)[Nominal];
+        }
+        std::chrono::duration<double> direct = std::chrono::steady_clock::now() - start;
+
+        float shared_sum = 0;
+        start = std::chrono::steady_clock::now();
+        for (const auto& p: parameters) {
+            context.set_parameters(p);
+            for (size_t i = 0; i < values.size(); i++)
+                shared_sum += context.get(values[i], layouts[i])[Nominal];
+        }
+        std::chrono::duration<double> shared = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(direct_sum == shared_sum);
+
+        std::cout << std::left << std::setw(30) << configuration << std::right << std::setw(8) << values.size() << std::setw(10) << context.size()
+            << std::fixed << std::setprecision(0) << std::setw(16) << direct.count() / N_OBJECTS * 1e9 << std::setw(16) << shared.count() / N_OBJECTS * 1e9
+            << std::setprecision(2) << std::setw(10) << direct.count() / shared.count() << std::endl;
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * Unit tests of the process-wide scale-factors cache, built against the stand-ins of test/standin.
+ * See CMakeLists.txt at the root of the package.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include <cp3_llbb/Framework/interface/catch.hpp>
+
+#include <cp3_llbb/Framework/interface/ScaleFactorsRegistry.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+    const std::string DATA_DIR = SCALEFACTORS_DATA_DIR;
+
+    const std::string FIRST = DATA_DIR + "/Muon_TightID_genTracks_id_BCDEF.json";
+    const std::string SECOND = DATA_DIR + "/Muon_TightID_genTracks_id_GH.json";
+
+    std::vector<edm::ParameterSet> parts(double first_weight, double second_weight) {
+        std::vector<edm::ParameterSet> result(2);
+        result[0].addUntrackedParameter("file", edm::FileInPath(FIRST));
+        result[0].addUntrackedParameter("weight", first_weight);
+        result[1].addUntrackedParameter("file", edm::FileInPath(SECOND));
+        result[1].addUntrackedParameter("weight", second_weight);
+
+        return result;
+    }
+}
+
+TEST_CASE("Scale-factors are loaded once per process", "[registry]") {
+    ScaleFactorsRegistry& registry = ScaleFactorsRegistry::get();
+
+    SECTION("Same file") {
+        auto values = registry.load(edm::FileInPath(FIRST));
+        REQUIRE(values);
+        REQUIRE(registry.load(edm::FileInPath(FIRST)) == values);
+
+        // Files are identified by their canonical path
+        REQUIRE(registry.load(edm::FileInPath(DATA_DIR + "/../ScaleFactors/Muon_TightID_genTracks_id_BCDEF.json")) == values);
+
+        REQUIRE(registry.load(edm::FileInPath(SECOND)) != values);
+    }
+
+    SECTION("Same weighted files") {
+        auto weighted = registry.load(parts(0.3, 0.2));
+        REQUIRE(weighted);
+        REQUIRE(registry.load(parts(0.3, 0.2)) == weighted);
+
+        REQUIRE(registry.load(parts(0.2, 0.3)) != weighted);
+        REQUIRE(registry.load(parts(0.3, 0.2), true) != weighted);
+    }
+
+    SECTION("Same combined files") {
+        auto combined = registry.load(parts(0.3, 0.2), true);
+        REQUIRE(combined);
+        REQUIRE(registry.load(parts(0.3, 0.2), true) == combined);
+
+        REQUIRE(registry.load(parts(0.2, 0.3), true) != combined);
+    }
+}